@@ -3,26 +3,117 @@
 import matplotlib.pyplot as plt
 import matplotlib.collections as pltc
 
+import struct
+
 from math import sqrt
 from typing import List, Tuple, Dict, Set
 from argparse import ArgumentParser
 
 
 def read_data_from_stream(f):
+    """
+    returns the points, the edges and the triangles, which are None
+    unless the file was written with --output-format triangles
+    """
     n = int(f.readline())
     points = []
     for i in range(n):
         line = f.readline().split(' ')
         points.append((float(line[0]), float(line[1])))
     edges = []
+    tris = None
+    seen = set()
     for line in f:
-        line = line.split(' ')
-        x, y = int(line[0]), int(line[1])
-        edges.append((x, y))
-    return points, edges
+        line = line.split()
+        if len(line) == 6:
+            a, b, c, na, nb, nc = map(int, line)
+            tris = [] if tris is None else tris
+            tris.append((a, b, c))
+            # every inner edge is listed by the lower of its triangles
+            t = len(tris) - 1
+            for (x, y), nt in (((b, c), na), ((c, a), nb), ((a, b), nc)):
+                if nt == -1 or nt > t:
+                    edges.append((x, y))
+        elif len(line) == 3:
+            # out of core, the triangles come without their neighbors
+            a, b, c = map(int, line)
+            tris = [] if tris is None else tris
+            tris.append((a, b, c))
+            for x, y in ((a, b), (b, c), (c, a)):
+                if (min(x, y), max(x, y)) not in seen:
+                    seen.add((min(x, y), max(x, y)))
+                    edges.append((x, y))
+        else:
+            x, y = int(line[0]), int(line[1])
+            edges.append((x, y))
+    return points, edges, tris
+
+
+def read_varints(data, at, count):
+    """
+    returns `count` LEB128 varints read from `data` at `at`, and where they
+    end
+    """
+    values = []
+    for _ in range(count):
+        value, shift = 0, 0
+        while True:
+            byte = data[at]
+            at += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if byte < 0x80:
+                break
+        values.append(value)
+    return values, at
+
+
+def read_binary_mesh(data):
+    """
+    like read_data_from_stream, for a file written with --output-encoding
+    packed or plain; the points keep the Hilbert order of the file
+    """
+    kind, encoding, block_size, n, m = struct.unpack_from("<IIIQQ", data, 4)
+    at = 32
+    flat = struct.unpack_from("<%dd" % (2 * n), data, at)
+    points = list(zip(flat[0::2], flat[1::2]))
+    at += 20 * n
+    at += -at % 8
+    if encoding == 0:
+        fields = 6 if kind == 1 else 2
+        flat = struct.unpack_from("<" + ("IIIiii" if kind == 1 else "II") * m,
+                                  data, at)
+        elements = [flat[i:i + fields] for i in range(0, len(flat), fields)]
+    else:
+        elements = []
+        for start in range(0, m, block_size):
+            previous = 0
+            for i in range(start, min(start + block_size, m)):
+                if kind == 0:
+                    (da, db), at = read_varints(data, at, 2)
+                    previous += da
+                    elements.append((previous, previous + db))
+                    continue
+                (da, db, dc, *ns), at = read_varints(data, at, 6)
+                previous += da
+                # neighbors are zigzag coded from the triangle, 0 on the hull
+                ns = [-1 if z == 0 else i + ((z >> 1) ^ -(z & 1)) for z in ns]
+                elements.append((previous, previous + db, previous + dc, *ns))
+    if kind == 0:
+        return points, elements, None
+    edges = []
+    for t, (a, b, c, na, nb, nc) in enumerate(elements):
+        for (x, y), nt in (((b, c), na), ((c, a), nb), ((a, b), nc)):
+            if nt == -1 or nt > t:
+                edges.append((x, y))
+    return points, edges, [e[:3] for e in elements]
 
 
 def read_data(path: str):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] == b"DTMB":
+        return read_binary_mesh(data)
     with open(path) as f:
         return read_data_from_stream(f)
 
@@ -104,8 +195,9 @@ def triangles_to_circles(points, tris):
     return result
 
 
-def circumcircles_from_data(points, edges):
-    tris = triangles(edges)
+def circumcircles_from_data(points, edges, tris=None):
+    if tris is None:
+        tris = triangles(edges)
     return triangles_to_circles(points, tris)
 
 
@@ -139,7 +231,7 @@ def cmd_parser():
     return parser
 
 
-def plot(points, edges, args):
+def plot(points, edges, tris, args):
     xs, ys = split_list(points)
     lines = pltc.LineCollection(
         edges_to_segments(
@@ -152,7 +244,7 @@ def plot(points, edges, args):
     plt.scatter(xs, ys, s=[3], color="black")
 
     if args.circle:
-        for c, r in circumcircles_from_data(points, edges):
+        for c, r in circumcircles_from_data(points, edges, tris):
             circle = plt.Circle(c, r, fill=False, color="gray", linewidth=0.6)
             ax.add_artist(circle)
 
@@ -170,5 +262,5 @@ def plot(points, edges, args):
 if __name__ == '__main__':
     args = cmd_parser().parse_args()
 
-    points, edges = read_data(args.input)
-    plot(points, edges, args)
+    points, edges, tris = read_data(args.input)
+    plot(points, edges, tris, args)
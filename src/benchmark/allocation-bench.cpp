@@ -0,0 +1,112 @@
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/types.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <malloc.h>
+#include <new>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Counts every heap operation made while triangulating, to keep an eye on
+// per-point allocations in the hot path, and the peak of the live heap
+// bytes, the memory footprint per point including input and output. A
+// second run through a TriangulationContext that already triangulated the
+// same points shows what is left once the setup is reused: nothing from
+// the merges, only the count tables of the radix sort of large inputs.
+
+namespace {
+
+std::atomic<long long> allocations{0};
+std::atomic<long long> deallocations{0};
+std::atomic<long long> live_bytes{0};
+std::atomic<long long> peak_bytes{0};
+
+void Track(long long delta) {
+    long long live = live_bytes += delta;
+    long long peak = peak_bytes.load();
+    while (live > peak and not peak_bytes.compare_exchange_weak(peak, live)) {
+    }
+}
+
+} // namespace
+
+void *operator new(size_t size) {
+    ++allocations;
+    if (void *p = malloc(size)) {
+        Track(malloc_usable_size(p));
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    if (p != nullptr) {
+        ++deallocations;
+        Track(-(long long)malloc_usable_size(p));
+    }
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+std::vector<Point2D> RandomPoints(int n, unsigned seed) {
+    std::vector<Point2D> points;
+    points.reserve(n);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dis(0, n * 5.);
+    for (int i = 0; i < n; ++i) {
+        points.emplace_back(dis(gen), dis(gen));
+    }
+    return points;
+}
+
+void Run(int n) {
+    auto inputs = TagPointWithIndex(RandomPoints(n, n));
+    DivideAndConquer algo;
+    long long alloc_before = allocations, dealloc_before = deallocations;
+    peak_bytes = live_bytes.load();
+    long long bytes_before = live_bytes - inputs.capacity() * sizeof(PointRef);
+    auto start_time = chrono::steady_clock::now();
+    auto edges = algo.Triangulate(std::move(inputs));
+    auto end_time = chrono::steady_clock::now();
+    long long allocs = allocations - alloc_before,
+              deallocs = deallocations - dealloc_before;
+    printf(
+        "%10d points: %10.2f ms, %10lld allocations, %10lld deallocations, "
+        "%.3f allocations per point, %.1f peak bytes per point\n",
+        n,
+        chrono::duration<double, std::milli>(end_time - start_time).count(),
+        allocs, deallocs, double(allocs) / n,
+        double(peak_bytes - bytes_before) / n);
+
+    auto again = TagPointWithIndex(RandomPoints(n, n));
+    TriangulationContext context;
+    std::vector<IdEdge> reused;
+    context.Triangulate(again, reused);
+    alloc_before = allocations;
+    context.Triangulate(again, reused);
+    printf(
+        "%10d points: %10lld allocations through a warm context\n", n,
+        allocations - alloc_before);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 1) {
+        for (int n : {1000, 100000, 1000000}) {
+            Run(n);
+        }
+        return 0;
+    }
+    for (int i = 1; i < argc; ++i) {
+        Run(atoi(argv[i]));
+    }
+}
@@ -0,0 +1,120 @@
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Throughput on many small point sets: a fresh DivideAndConquer run per
+// set, one TriangulationContext reused for all of them, and the sets
+// spread over a BatchTriangulator. All three keep their triangles, about
+// 300 bytes a point together, and must give the same ones. The setup a
+// context saves is some microseconds a set, so each is timed over a few
+// rounds and the fastest round reported.
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+double Milliseconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, std::milli>(
+               chrono::steady_clock::now() - since)
+        .count();
+}
+
+// whether `a` and `b` are the same triangles in the same order
+bool SameTriangles(
+    const Triangulator::OutputTriangles &a,
+    const Triangulator::OutputTriangles &b) {
+    return std::equal(
+        begin(a), end(a), begin(b), end(b),
+        [](const IdTriangle &l, const IdTriangle &r) {
+            return std::equal(l.vertices, l.vertices + 3, r.vertices) and
+                   std::equal(l.neighbors, l.neighbors + 3, r.neighbors);
+        });
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    int min_size = argc > 2 ? atoi(argv[2]) : 10;
+    int max_size = argc > 3 ? atoi(argv[3]) : 500;
+    int threads = argc > 4 ? atoi(argv[4]) : 4;
+    int rounds = argc > 5 ? atoi(argv[5]) : 3;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> size(min_size, max_size);
+    std::uniform_real_distribution<double> dis(0, 1000.);
+    std::vector<Triangulator::InputPoints> problems(count);
+    long long points = 0;
+    for (auto &problem : problems) {
+        std::vector<Point2D> pts(size(gen));
+        for (auto &p : pts) {
+            p = Point2D(dis(gen), dis(gen));
+        }
+        problem = TagPointWithIndex(pts);
+        points += pts.size();
+    }
+    printf(
+        "%d point sets of %d to %d points, %lld points\n", count, min_size,
+        max_size, points);
+
+    auto report = [&](const char *name, double ms) {
+        printf(
+            "%-24s %10.2f ms, %8.2f us per set, %6.1f M points/s\n", name, ms,
+            ms * 1e3 / count, points / ms / 1e3);
+    };
+
+    std::vector<Triangulator::OutputTriangles> fresh(count), reused(count),
+        batched;
+    DivideAndConquer algo;
+    TriangulationContext context;
+    BatchTriangulator batch(threads);
+    // the time of `f` added to `ms`
+    auto time = [](double &ms, const auto &f) {
+        auto start_time = chrono::steady_clock::now();
+        f();
+        ms += Milliseconds(start_time);
+    };
+
+    // The fastest of `rounds` rounds. Fresh runs and runs through the
+    // context take turns set by set, each going first every other time,
+    // so a slow spell of the machine weighs on both alike.
+    double fresh_ms = 0, reused_ms = 0, batched_ms = 0;
+    for (int round = 0; round < rounds; ++round) {
+        double f = 0, r = 0, b = 0;
+        for (int i = 0; i < count; ++i) {
+            auto run_fresh = [&] {
+                fresh[i] = algo.TriangulateFaces(problems[i]);
+            };
+            auto run_reused = [&] {
+                context.TriangulateFaces(problems[i], reused[i]);
+            };
+            if (i % 2 == 0) {
+                time(f, run_fresh);
+                time(r, run_reused);
+            } else {
+                time(r, run_reused);
+                time(f, run_fresh);
+            }
+        }
+        time(b, [&] { batch.TriangulateFaces(problems, batched); });
+        fresh_ms = round == 0 ? f : std::min(fresh_ms, f);
+        reused_ms = round == 0 ? r : std::min(reused_ms, r);
+        batched_ms = round == 0 ? b : std::min(batched_ms, b);
+    }
+    report("fresh run per set", fresh_ms);
+    report("reused context", reused_ms);
+    char name[64];
+    snprintf(name, sizeof(name), "batch on %d threads", threads);
+    report(name, batched_ms);
+
+    for (int i = 0; i < count; ++i) {
+        if (not SameTriangles(reused[i], fresh[i]) or
+            not SameTriangles(batched[i], fresh[i])) {
+            fprintf(stderr, "set %d: the triangulations differ\n", i);
+            return 1;
+        }
+    }
+}
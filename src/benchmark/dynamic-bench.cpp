@@ -0,0 +1,71 @@
+#include "triangulation/algorithms/incremental/dynamic.h"
+#include "triangulation/algorithms/incremental/triangulate.h"
+#include "triangulation/types.h"
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Cost of keeping a triangulation up to date under a stream of small
+// changes, against triangulating the changed point set from scratch.
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+double Milliseconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, std::milli>(
+               chrono::steady_clock::now() - since)
+        .count();
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int changes = argc > 2 ? atoi(argv[2]) : 2000;
+    int ticks = argc > 3 ? atoi(argv[3]) : 10;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(0, n * 5.);
+    auto random_points = [&](int count) {
+        std::vector<Point2D> pts;
+        for (int i = 0; i < count; ++i) {
+            pts.emplace_back(dis(gen), dis(gen));
+        }
+        return pts;
+    };
+
+    DynamicTriangulation dynamic;
+    auto start_time = chrono::steady_clock::now();
+    std::vector<Index> ids = dynamic.InsertMany(random_points(n));
+    printf("%d points inserted in %.2f ms\n", n, Milliseconds(start_time));
+
+    double update_ms = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        auto added = random_points(changes);
+        start_time = chrono::steady_clock::now();
+        for (int i = 0; i < changes; ++i) {
+            size_t k = gen() % ids.size();
+            dynamic.Remove(ids[k]);
+            ids[k] = ids.back();
+            ids.pop_back();
+        }
+        for (Index id : dynamic.InsertMany(added)) {
+            ids.push_back(id);
+        }
+        update_ms += Milliseconds(start_time);
+    }
+    printf(
+        "%d ticks of %d removals and %d insertions: %.3f ms per tick, "
+        "%.2f us per update\n",
+        ticks, changes, changes, update_ms / ticks,
+        update_ms * 1e3 / (ticks * 2. * changes));
+
+    std::vector<Point2D> pts;
+    for (Index id : ids) {
+        pts.push_back(dynamic.Point(id));
+    }
+    start_time = chrono::steady_clock::now();
+    Incremental().Triangulate(TagPointWithIndex(pts));
+    printf("rebuilding from scratch: %.2f ms\n", Milliseconds(start_time));
+}
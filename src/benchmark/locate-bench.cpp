@@ -0,0 +1,105 @@
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/query/point-locator.h"
+#include "triangulation/types.h"
+#include "triangulation/utility.h"
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Query times of a PointLocator over a uniform random triangulation, one
+// query at a time and in batches, checked against brute force on a sample.
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+double Milliseconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, std::milli>(
+               chrono::steady_clock::now() - since)
+        .count();
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int count = argc > 2 ? atoi(argv[2]) : 1000000;
+    int threads = argc > 3 ? atoi(argv[3]) : 4;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(0, n * 5.);
+    std::vector<Point2D> pts(n);
+    for (auto &p : pts) {
+        p = Point2D(dis(gen), dis(gen));
+    }
+    auto triangles = DivideAndConquer().TriangulateFaces(TagPointWithIndex(pts));
+
+    auto start_time = chrono::steady_clock::now();
+    PointLocator locator(pts.data(), pts.size(), triangles);
+    printf("%d points, index built in %.2f ms\n", n, Milliseconds(start_time));
+
+    // a few queries fall outside the hull
+    std::uniform_real_distribution<double> around(-n * .05, n * 5.05);
+    std::vector<Point2D> queries(count);
+    for (auto &q : queries) {
+        q = Point2D(around(gen), around(gen));
+    }
+    std::vector<Index> located(count), nearest(count);
+    auto report = [&](const char *name, double ms) {
+        printf(
+            "%-28s %10.2f ms, %8.3f us per query\n", name, ms,
+            ms * 1e3 / count);
+    };
+
+    start_time = chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        located[i] = locator.Locate(queries[i]);
+    }
+    report("locate", Milliseconds(start_time));
+    start_time = chrono::steady_clock::now();
+    locator.Locate(queries.data(), count, located.data(), threads);
+    report("batched locate", Milliseconds(start_time));
+
+    start_time = chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        nearest[i] = locator.NearestVertex(queries[i]);
+    }
+    report("nearest vertex", Milliseconds(start_time));
+    start_time = chrono::steady_clock::now();
+    locator.NearestVertices(queries.data(), count, nearest.data(), threads);
+    report("batched nearest vertex", Milliseconds(start_time));
+
+    for (int i = 0; i < std::min(count, 200); ++i) {
+        const Point2D &q = queries[i];
+        Index best = 0;
+        for (int v = 1; v < n; ++v) {
+            if ((pts[v] - q).squaredNorm() < (pts[best] - q).squaredNorm()) {
+                best = v;
+            }
+        }
+        bool inside = located[i] != kNoNeighbor;
+        if (inside) {
+            const Index *v = triangles[located[i]].vertices;
+            for (int k = 0; k < 3; ++k) {
+                inside &= ComputeOrientation(
+                              pts[v[k]], pts[v[(k + 1) % 3]], q) !=
+                          kClockwise;
+            }
+        }
+        bool outside = true;
+        for (const auto &t : triangles) {
+            bool in = true;
+            for (int k = 0; k < 3; ++k) {
+                in &= ComputeOrientation(
+                          pts[t.vertices[k]], pts[t.vertices[(k + 1) % 3]],
+                          q) != kClockwise;
+            }
+            outside &= not in;
+        }
+        if (inside == outside or (pts[nearest[i]] - q).squaredNorm() !=
+                                     (pts[best] - q).squaredNorm()) {
+            fprintf(stderr, "query %d answered wrong\n", i);
+            return 1;
+        }
+    }
+}
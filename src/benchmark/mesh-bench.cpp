@@ -0,0 +1,187 @@
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/io/binary-mesh.h"
+#include "triangulation/io/point-set.h"
+#include "triangulation/io/text-output.h"
+#include "triangulation/types.h"
+#include "triangulation/utility.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// Size and write and read times of the edges and the triangles of a
+// uniform random triangulation as text and as packed and plain binary mesh
+// files, the binary ones read back and checked against the original.
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+double Milliseconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, std::milli>(
+               chrono::steady_clock::now() - since)
+        .count();
+}
+
+// the triangle with its input vertices, from the least one on
+std::array<Index, 3> Canonical(const Index *v) {
+    int k = std::min_element(v, v + 3) - v;
+    return {v[k], v[(k + 1) % 3], v[(k + 2) % 3]};
+}
+
+// whether `mesh` is the triangulation of `pts` in `edges` or `triangles`,
+// renumbered
+bool SameMesh(
+    const BinaryMesh &mesh, const std::vector<Point2D> &pts,
+    const std::vector<IdEdge> &edges,
+    const std::vector<IdTriangle> &triangles) {
+    if (mesh.points.size() != pts.size()) {
+        return false;
+    }
+    for (size_t v = 0; v < pts.size(); ++v) {
+        if (mesh.points[v] != pts[mesh.ids[v]]) {
+            return false;
+        }
+    }
+    if (not mesh.faces) {
+        auto pairs = [](const std::vector<IdEdge> &es, const auto &id) {
+            std::vector<std::pair<Index, Index>> result;
+            for (const auto &e : es) {
+                result.emplace_back(
+                    std::min(id(e.p1), id(e.p2)), std::max(id(e.p1), id(e.p2)));
+            }
+            std::sort(begin(result), end(result));
+            return result;
+        };
+        return pairs(edges, [](Index v) { return v; }) ==
+               pairs(mesh.edges, [&](Index v) { return mesh.ids[v]; });
+    }
+    if (mesh.triangles.size() != triangles.size()) {
+        return false;
+    }
+    std::vector<std::pair<std::array<Index, 3>, Index>> keys;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        keys.emplace_back(Canonical(triangles[t].vertices), t);
+    }
+    std::sort(begin(keys), end(keys));
+    // the original triangle of every one read back
+    std::vector<Index> original(mesh.triangles.size());
+    for (size_t t = 0; t < mesh.triangles.size(); ++t) {
+        Index v[3];
+        for (int k = 0; k < 3; ++k) {
+            v[k] = mesh.ids[mesh.triangles[t].vertices[k]];
+        }
+        auto key = Canonical(v);
+        auto it = std::lower_bound(
+            begin(keys), end(keys), std::make_pair(key, Index(0)));
+        if (it == end(keys) or it->first != key) {
+            return false;
+        }
+        original[t] = it->second;
+    }
+    for (size_t t = 0; t < mesh.triangles.size(); ++t) {
+        const IdTriangle &read = mesh.triangles[t];
+        const IdTriangle &from = triangles[original[t]];
+        for (int k = 0; k < 3; ++k) {
+            int j = std::find(
+                        from.vertices, from.vertices + 3,
+                        mesh.ids[read.vertices[k]]) -
+                    from.vertices;
+            Index n = read.neighbors[k];
+            if ((n == kNoNeighbor ? kNoNeighbor : original[n]) !=
+                from.neighbors[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int threads = argc > 2 ? atoi(argv[2]) : 4;
+    std::string path =
+        std::string(argc > 3 ? argv[3] : "/tmp") + "/mesh-bench.out";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(0, n * 5.);
+    std::vector<Point2D> pts(n);
+    for (auto &p : pts) {
+        p = Point2D(dis(gen), dis(gen));
+    }
+    auto triangles = DivideAndConquer().TriangulateFaces(TagPointWithIndex(pts));
+    auto edges = DivideAndConquer().Triangulate(TagPointWithIndex(pts));
+    PointSet points(pts);
+    printf(
+        "%d points, %zu edges, %zu triangles\n", n, edges.size(),
+        triangles.size());
+
+    bool failed = false;
+    for (bool faces : {false, true}) {
+        size_t elements = faces ? triangles.size() : edges.size();
+        for (int encoding = -1; encoding <= 1; ++encoding) {
+            FILE *f = fopen(path.c_str(), "wb");
+            if (f == nullptr) {
+                fprintf(stderr, "cannot open %s\n", path.c_str());
+                return 1;
+            }
+            auto start_time = chrono::steady_clock::now();
+            bool ok;
+            if (encoding < 0) {
+                ok = WritePointsText(points, f, threads) and
+                     (faces ? WriteTrianglesText(triangles, f, threads)
+                            : WriteEdgesText(edges, f, threads));
+            } else if (faces) {
+                ok = WriteBinaryMeshTriangles(
+                    points, triangles, MeshEncoding(encoding), f, threads);
+            } else {
+                ok = WriteBinaryMeshEdges(
+                    points, edges, MeshEncoding(encoding), f, threads);
+            }
+            ok = fflush(f) == 0 and ok;
+            double write_ms = Milliseconds(start_time);
+            double bytes = ftell(f);
+            fclose(f);
+            if (not ok) {
+                fprintf(stderr, "cannot write %s\n", path.c_str());
+                return 1;
+            }
+
+            const char *name = encoding < 0   ? "text"
+                               : encoding == 0 ? "plain"
+                                               : "packed";
+            // the points take the same room in either binary encoding
+            double element_bytes =
+                encoding < 0 ? 0 : bytes - 20. * n - sizeof(BinaryMeshHeader);
+            printf(
+                "%-9s %-6s %10.0f bytes", faces ? "triangles" : "edges", name,
+                bytes);
+            if (encoding >= 0) {
+                printf(", %5.2f per element", element_bytes / elements);
+            }
+            printf(", written in %8.2f ms", write_ms);
+            if (encoding >= 0) {
+                std::string error;
+                start_time = chrono::steady_clock::now();
+                auto mesh = ReadBinaryMesh(path.c_str(), threads, error);
+                double read_ms = Milliseconds(start_time);
+                if (not mesh) {
+                    fprintf(stderr, "\n%s\n", error.c_str());
+                    return 1;
+                }
+                printf(", read in %8.2f ms", read_ms);
+                if (not SameMesh(*mesh, pts, edges, triangles)) {
+                    printf(", NOT THE SAME MESH");
+                    failed = true;
+                }
+            }
+            printf("\n");
+        }
+    }
+    remove(path.c_str());
+    return failed;
+}
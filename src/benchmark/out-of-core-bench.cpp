@@ -0,0 +1,123 @@
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/algorithms/out-of-core/triangulate.h"
+#include "triangulation/io/point-set.h"
+#include "triangulation/point-distributions.h"
+#include "triangulation/types.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Out-of-core against in-memory triangulation of the seeded distributions,
+// with strips far smaller than the input: the times, the peak points held
+// at once, and whether both gave the same triangles. Grids and circles are
+// full of cocircular points, where either triangulation is as good as the
+// other, so only their triangle counts are compared. Circles and strips
+// keep most of their points on the frontier and are slow out of core.
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+double Milliseconds(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, std::milli>(
+               chrono::steady_clock::now() - since)
+        .count();
+}
+
+// the triangle with its input vertices, from the least one on
+std::array<Index, 3> Canonical(const Index *v) {
+    int k = std::min_element(v, v + 3) - v;
+    return {v[k], v[(k + 1) % 3], v[(k + 2) % 3]};
+}
+
+// the "a b c" triangles of the text written out of core for `n` points
+std::vector<std::array<Index, 3>> ParseTriangles(const char *text, Index n) {
+    for (Index i = 0; i <= n; ++i) {
+        text = strchr(text, '\n') + 1;
+    }
+    std::vector<std::array<Index, 3>> result;
+    while (*text != '\0') {
+        Index v[3];
+        for (auto &x : v) {
+            char *end;
+            x = strtoll(text, &end, 10);
+            text = end;
+        }
+        result.push_back(Canonical(v));
+        text = strchr(text, '\n') + 1;
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    Index n = argc > 1 ? atoll(argv[1]) : 100000;
+    Index tile_points = argc > 2 ? atoll(argv[2]) : 5000;
+    int threads = argc > 3 ? atoi(argv[3]) : 1;
+    std::string dir = argc > 4 ? argv[4] : "/tmp";
+    std::string path = dir + "/out-of-core-bench.pts";
+    printf(
+        "%lld points, strips of %lld\n", (long long)n, (long long)tile_points);
+
+    bool failed = false;
+    for (Distribution d : kAllDistributions) {
+        auto pts = GeneratePoints(d, n, 42);
+        if (not WriteBinaryPoints(PointSet(pts), path.c_str())) {
+            fprintf(stderr, "cannot write %s\n", path.c_str());
+            return 1;
+        }
+
+        auto start_time = chrono::steady_clock::now();
+        auto triangles =
+            DivideAndConquer().TriangulateFaces(TagPointWithIndex(pts));
+        double memory_ms = Milliseconds(start_time);
+        std::vector<std::array<Index, 3>> expected;
+        for (const auto &t : triangles) {
+            expected.push_back(Canonical(t.vertices));
+        }
+
+        char *text = nullptr;
+        size_t size = 0;
+        FILE *out = open_memstream(&text, &size);
+        OutOfCoreOptions options;
+        options.tile_points = tile_points;
+        options.temp_dir = dir;
+        options.threads = threads;
+        OutOfCoreStats stats;
+        std::string error;
+        start_time = chrono::steady_clock::now();
+        bool ok =
+            TriangulateOutOfCore(path.c_str(), out, options, stats, error);
+        double out_of_core_ms = Milliseconds(start_time);
+        fclose(out);
+        if (not ok) {
+            fprintf(stderr, "%s\n", error.c_str());
+            free(text);
+            return 1;
+        }
+        auto found = ParseTriangles(text, n);
+        free(text);
+
+        bool same;
+        if (d == Distribution::kGrid or d == Distribution::kCircle) {
+            same = found.size() == expected.size();
+        } else {
+            std::sort(begin(expected), end(expected));
+            std::sort(begin(found), end(found));
+            same = found == expected;
+        }
+        printf(
+            "%-10s %8zu triangles, in memory %9.2f ms, out of core %9.2f ms "
+            "over %4lld strips, peak %8lld points%s\n",
+            DistributionName(d), expected.size(), memory_ms, out_of_core_ms,
+            (long long)stats.tiles, (long long)stats.peak_points,
+            same ? "" : ", NOT THE SAME TRIANGLES");
+        failed = failed or not same;
+    }
+    remove(path.c_str());
+    return failed;
+}
@@ -0,0 +1,161 @@
+#include "triangulation/batch-predicates.h"
+#include "triangulation/predicates.h"
+#include "triangulation/types.h"
+#include "triangulation/utility.h"
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Throughput of the orientation and in-circle predicates, and how often
+// they fall back to exact arithmetic, on inputs of varying degeneracy.
+
+using namespace triangulation;
+namespace chrono = std::chrono;
+
+// the in-circle test as it was before the filtered predicates, as a
+// reference for the fast path
+bool EigenInCircle(
+    const Point2D &a, const Point2D &b, const Point2D &c, const Point2D &d) {
+    double adx = a(0) - d(0), ady = a(1) - d(1), bdx = b(0) - d(0),
+           bdy = b(1) - d(1), cdx = c(0) - d(0), cdy = c(1) - d(1);
+    Eigen::Matrix3d m;
+    m << adx, ady, (Square(adx) + Square(ady)), bdx, bdy,
+        (Square(bdx) + Square(bdy)), cdx, cdy, (Square(cdx) + Square(cdy));
+    return m.determinant() > 0;
+}
+
+std::vector<Point2D> UniformPoints(int n, std::mt19937 &gen) {
+    std::uniform_real_distribution<double> dis(0, 1000);
+    std::vector<Point2D> pts;
+    for (int i = 0; i < n; ++i) {
+        pts.emplace_back(dis(gen), dis(gen));
+    }
+    return pts;
+}
+
+// points on a coarse integer grid, full of collinear and cocircular sets
+std::vector<Point2D> GridPoints(int n, std::mt19937 &gen) {
+    std::uniform_int_distribution<int> dis(0, 8);
+    std::vector<Point2D> pts;
+    for (int i = 0; i < n; ++i) {
+        pts.emplace_back(dis(gen), dis(gen));
+    }
+    return pts;
+}
+
+// points within a few ulps of the line y = x
+std::vector<Point2D> NearLinePoints(int n, std::mt19937 &gen) {
+    std::uniform_real_distribution<double> dis(0, 1);
+    std::uniform_int_distribution<int> ulps(-4, 4);
+    std::vector<Point2D> pts;
+    for (int i = 0; i < n; ++i) {
+        double x = dis(gen), y = x;
+        for (int k = ulps(gen); k != 0; k += k > 0 ? -1 : 1) {
+            y = nextafter(y, k > 0 ? 2.0 : -1.0);
+        }
+        pts.emplace_back(x, y);
+    }
+    return pts;
+}
+
+template <typename F>
+void Measure(const char *name, const std::vector<Point2D> &pts, int rounds, F f) {
+    predicates::ResetExactFallbacks();
+    long long sink = 0, calls = 0;
+    auto start_time = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i + 3 < pts.size(); ++i) {
+            sink += f(pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
+            ++calls;
+        }
+    }
+    auto end_time = chrono::steady_clock::now();
+    double ns = chrono::duration<double, std::nano>(end_time - start_time)
+                    .count();
+    auto fallbacks = predicates::ExactFallbacks();
+    long long exact = fallbacks.orientation + fallbacks.in_circle;
+    printf(
+        "%-28s %8.2f ns/call %9.2f M calls/s %8.4f%% exact (%lld)\n", name,
+        ns / calls, calls / ns * 1e3, 100. * exact / calls, sink);
+}
+
+// batched predicates over windows of `width` consecutive points, reported
+// per evaluated lane so the numbers compare with the scalar calls above
+template <typename F>
+void MeasureBatch(
+    const char *name, const std::vector<Point2D> &pts, int rounds, int width,
+    F f) {
+    predicates::ResetExactFallbacks();
+    PointBatch batch;
+    std::vector<int8_t> signs;
+    long long sink = 0, lanes = 0;
+    auto start_time = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i + width + 2 <= pts.size(); i += width) {
+            batch.Clear();
+            for (int k = 0; k < width; ++k) {
+                batch.Push(pts[i + 2 + k]);
+            }
+            f(pts[i], pts[i + 1], batch, signs);
+            sink += signs[0];
+            lanes += signs.size();
+        }
+    }
+    auto end_time = chrono::steady_clock::now();
+    double ns = chrono::duration<double, std::nano>(end_time - start_time)
+                    .count();
+    auto fallbacks = predicates::ExactFallbacks();
+    long long exact = fallbacks.orientation + fallbacks.in_circle;
+    printf(
+        "%-28s %8.2f ns/lane %9.2f M lanes/s %8.4f%% exact (%lld)\n", name,
+        ns / lanes, lanes / ns * 1e3, 100. * exact / lanes, sink);
+}
+
+void RunBatches(const std::vector<Point2D> &pts, int rounds) {
+    char name[64];
+    for (auto kernel :
+         {BatchKernel::kScalar, BatchKernel::kSse2, BatchKernel::kAvx2}) {
+        if (not SelectBatchKernel(kernel)) {
+            continue;
+        }
+        for (int width : {8, 64}) {
+            snprintf(
+                name, sizeof(name), "BatchOrientation %s/%d",
+                BatchKernelName(kernel), width);
+            MeasureBatch(name, pts, rounds, width, BatchOrientation);
+            snprintf(
+                name, sizeof(name), "BatchInCircle %s/%d",
+                BatchKernelName(kernel), width);
+            MeasureBatch(name, pts, rounds, width, BatchInCircleOfNeighbors);
+        }
+    }
+}
+
+void Run(const char *name, const std::vector<Point2D> &pts, int rounds) {
+    printf("-- %s\n", name);
+    Measure(
+        "ComputeOrientation", pts, rounds,
+        [](const Point2D &a, const Point2D &b, const Point2D &c,
+           const Point2D &) { return (int)ComputeOrientation(a, b, c); });
+    Measure(
+        "InCircle", pts, rounds,
+        [](const Point2D &a, const Point2D &b, const Point2D &c,
+           const Point2D &d) { return (int)InCircle(a, b, c, d); });
+    Measure(
+        "InCircle (Eigen, inexact)", pts, rounds,
+        [](const Point2D &a, const Point2D &b, const Point2D &c,
+           const Point2D &d) { return (int)EigenInCircle(a, b, c, d); });
+    RunBatches(pts, rounds);
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1 << 16;
+    int rounds = argc > 2 ? atoi(argv[2]) : 100;
+    std::mt19937 gen(42);
+    Run("uniform", UniformPoints(n, gen), rounds);
+    Run("grid", GridPoints(n, gen), rounds);
+    Run("near line", NearLinePoints(n, gen), rounds);
+}
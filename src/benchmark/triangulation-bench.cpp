@@ -0,0 +1,324 @@
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/algorithms/incremental/triangulate.h"
+#include "triangulation/algorithms/interface.h"
+#include "triangulation/algorithms/sweep-hull/triangulate.h"
+#include "triangulation/point-distributions.h"
+#include "triangulation/types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// Times every triangulator over seeded point distributions and sizes and
+// prints the results as JSON, to compare runs across releases.
+//
+// Every (algorithm, distribution, size) case runs in a child process, so
+// its peak RSS is its own and a crash only marks that case as failed.
+
+using namespace triangulation;
+using namespace std::string_view_literals;
+namespace chrono = std::chrono;
+
+namespace {
+
+constexpr const char *kAlgorithms[] = {
+    "divide-and-conquer", "alternating-cuts",  "float-coordinates",
+    "int32-coordinates",  "incremental",       "sweep-hull"};
+
+constexpr const char *kHelpMessage =
+    "usage: triangulation-bench [--algorithms a,b,...] "
+    "[--distributions a,b,...]\n"
+    "[--sizes n,m,...] [--repetitions <int>] [--seed <int>] "
+    "[--threads <int>] [-o file]\n"
+    "\n"
+    "--algorithms = divide-and-conquer,alternating-cuts,float-coordinates,\n"
+    "\tint32-coordinates,incremental,sweep-hull\n"
+    "\tThe coordinate variants round the points to float and to integers\n"
+    "--distributions = uniform,clusters,grid,circle,strips,duplicates\n"
+    "--sizes = 1e3,1e4,1e5,1e6\n\tUp to 1e8, in any floating point notation\n"
+    "--repetitions <int> = 5\n\tTimed runs per case, after one warm-up run\n"
+    "--seed <int> = 42\n"
+    "--threads <int> = 1\n\tPassed to the divide-and-conquer variants\n"
+    "-o file\n\tWrite the JSON report to file instead of stdout\n";
+
+struct Options {
+    std::vector<std::string> algorithms{
+        std::begin(kAlgorithms), std::end(kAlgorithms)};
+    std::vector<Distribution> distributions{
+        std::begin(kAllDistributions), std::end(kAllDistributions)};
+    std::vector<Index> sizes{1000, 10000, 100000, 1000000};
+    int repetitions = 5;
+    uint32_t seed = 42;
+    int threads = 1;
+};
+
+struct CaseResult {
+    bool ok = false;
+    // how the child process ended when not ok
+    std::string failure;
+    long long edges = 0;
+    std::vector<double> times_ms;
+    long peak_rss_kb = 0;
+};
+
+std::vector<std::string> SplitList(const char *list) {
+    std::vector<std::string> result;
+    std::string_view rest = list;
+    while (not rest.empty()) {
+        size_t comma = rest.find(',');
+        result.emplace_back(rest.substr(0, comma));
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        rest.remove_prefix(comma + 1);
+    }
+    return result;
+}
+
+std::unique_ptr<Triangulator>
+MakeTriangulator(const std::string &name, int threads) {
+    if (name == "divide-and-conquer") {
+        return std::make_unique<DivideAndConquer>(threads);
+    }
+    if (name == "alternating-cuts") {
+        return std::make_unique<DivideAndConquer>(
+            threads, DivideAndConquer::Cuts::kAlternating);
+    }
+    if (name == "float-coordinates") {
+        return std::make_unique<DivideAndConquer>(
+            threads, DivideAndConquer::Cuts::kVertical,
+            DivideAndConquer::Coordinates::kFloat);
+    }
+    if (name == "int32-coordinates") {
+        return std::make_unique<DivideAndConquer>(
+            threads, DivideAndConquer::Cuts::kVertical,
+            DivideAndConquer::Coordinates::kInt32);
+    }
+    if (name == "incremental") {
+        return std::make_unique<Incremental>();
+    }
+    if (name == "sweep-hull") {
+        return std::make_unique<SweepHull>();
+    }
+    return nullptr;
+}
+
+// linear interpolation between the closest ranks of the sorted `times`
+double Percentile(const std::vector<double> &times, double q) {
+    double rank = q * (times.size() - 1);
+    size_t lo = rank, hi = std::min(lo + 1, times.size() - 1);
+    return times[lo] + (times[hi] - times[lo]) * (rank - lo);
+}
+
+// the body of the child process, reports the edge count and one time per
+// repetition through `fd`
+void RunCase(
+    const Triangulator &algo, Distribution d, Index n, const Options &options,
+    int fd) {
+    auto pts = GeneratePoints(d, n, options.seed);
+    long long edges = 0;
+    std::vector<double> times;
+    for (int r = -1; r < options.repetitions; ++r) {
+        auto inputs = TagPointWithIndex(pts);
+        auto start_time = chrono::steady_clock::now();
+        edges = algo.Triangulate(std::move(inputs)).size();
+        auto end_time = chrono::steady_clock::now();
+        if (r >= 0) {
+            times.push_back(
+                chrono::duration<double, std::milli>(end_time - start_time)
+                    .count());
+        }
+    }
+    bool ok = write(fd, &edges, sizeof(edges)) == sizeof(edges) and
+              write(fd, times.data(), times.size() * sizeof(double)) ==
+                  ssize_t(times.size() * sizeof(double));
+    _exit(ok ? 0 : 1);
+}
+
+bool ReadAll(int fd, void *data, size_t size) {
+    char *p = (char *)data;
+    while (size > 0) {
+        ssize_t got = read(fd, p, size);
+        if (got <= 0) {
+            return false;
+        }
+        p += got;
+        size -= got;
+    }
+    return true;
+}
+
+CaseResult Run(
+    const Triangulator &algo, Distribution d, Index n,
+    const Options &options) {
+    CaseResult result;
+    int fds[2];
+    if (pipe(fds) == -1) {
+        result.failure = "pipe failed";
+        return result;
+    }
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        RunCase(algo, d, n, options, fds[1]);
+    }
+    close(fds[1]);
+    if (pid == -1) {
+        close(fds[0]);
+        result.failure = "fork failed";
+        return result;
+    }
+    result.times_ms.resize(options.repetitions);
+    bool complete =
+        ReadAll(fds[0], &result.edges, sizeof(result.edges)) and
+        ReadAll(
+            fds[0], result.times_ms.data(),
+            result.times_ms.size() * sizeof(double));
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    // kilobytes on Linux
+    result.peak_rss_kb = usage.ru_maxrss;
+    if (WIFSIGNALED(status)) {
+        result.failure =
+            std::string("killed by ") + strsignal(WTERMSIG(status));
+    } else if (not complete or WEXITSTATUS(status) != 0) {
+        result.failure = "exited without a result";
+    } else {
+        result.ok = true;
+    }
+    return result;
+}
+
+void PrintCase(
+    FILE *f, const std::string &algorithm, Distribution d, Index n,
+    const CaseResult &result, bool last) {
+    fprintf(
+        f,
+        "    {\"algorithm\": \"%s\", \"distribution\": \"%s\", "
+        "\"size\": %lld, ",
+        algorithm.c_str(), DistributionName(d), n);
+    if (not result.ok) {
+        fprintf(
+            f, "\"status\": \"failed\", \"error\": \"%s\"}%s\n",
+            result.failure.c_str(), last ? "" : ",");
+        return;
+    }
+    auto times = result.times_ms;
+    std::sort(begin(times), end(times));
+    double median = Percentile(times, 0.5);
+    fprintf(f, "\"status\": \"ok\", \"edges\": %lld,\n", result.edges);
+    fprintf(f, "     \"times_ms\": [");
+    for (size_t i = 0; i < result.times_ms.size(); ++i) {
+        fprintf(f, "%s%.3f", i == 0 ? "" : ", ", result.times_ms[i]);
+    }
+    fprintf(
+        f,
+        "],\n     \"min_ms\": %.3f, \"p10_ms\": %.3f, \"median_ms\": %.3f, "
+        "\"p90_ms\": %.3f, \"max_ms\": %.3f,\n"
+        "     \"points_per_second\": %.0f, \"peak_rss_kb\": %ld}%s\n",
+        times.front(), Percentile(times, 0.1), median, Percentile(times, 0.9),
+        times.back(), n / (median / 1000), result.peak_rss_kb,
+        last ? "" : ",");
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Options options;
+    FILE *out = stdout;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        auto value = [&] {
+            if (i + 1 == argc) {
+                fprintf(stderr, "%s: missing value for %s\n", argv[0], arg);
+                exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--algorithms"sv) {
+            options.algorithms = SplitList(value());
+        } else if (arg == "--distributions"sv) {
+            options.distributions.clear();
+            for (const auto &name : SplitList(value())) {
+                Distribution d;
+                if (not ParseDistribution(name.c_str(), d)) {
+                    fprintf(
+                        stderr, "%s: unknown distribution: %s\n", argv[0],
+                        name.c_str());
+                    exit(1);
+                }
+                options.distributions.push_back(d);
+            }
+        } else if (arg == "--sizes"sv) {
+            options.sizes.clear();
+            for (const auto &size : SplitList(value())) {
+                options.sizes.push_back(atof(size.c_str()));
+            }
+        } else if (arg == "--repetitions"sv) {
+            options.repetitions = std::max(1, atoi(value()));
+        } else if (arg == "--seed"sv) {
+            options.seed = strtoul(value(), nullptr, 10);
+        } else if (arg == "--threads"sv) {
+            options.threads = atoi(value());
+        } else if (arg == "-o"sv) {
+            const char *path = value();
+            out = fopen(path, "w");
+            if (out == nullptr) {
+                fprintf(stderr, "%s: cannot open %s\n", argv[0], path);
+                exit(1);
+            }
+        } else if (arg == "-h"sv or arg == "--help"sv) {
+            printf("%s", kHelpMessage);
+            exit(0);
+        } else {
+            fprintf(stderr, "%s: invalid option: %s\n", argv[0], arg);
+            exit(1);
+        }
+    }
+    for (const auto &name : options.algorithms) {
+        if (MakeTriangulator(name, options.threads) == nullptr) {
+            fprintf(
+                stderr, "%s: unknown algorithm: %s\n", argv[0], name.c_str());
+            exit(1);
+        }
+    }
+
+    fprintf(
+        out,
+        "{\n  \"seed\": %u, \"repetitions\": %d, \"threads\": %d,\n"
+        "  \"results\": [\n",
+        options.seed, options.repetitions, options.threads);
+    size_t cases = options.algorithms.size() * options.distributions.size() *
+                   options.sizes.size();
+    size_t done = 0;
+    for (const auto &name : options.algorithms) {
+        auto algo = MakeTriangulator(name, options.threads);
+        for (Distribution d : options.distributions) {
+            for (Index n : options.sizes) {
+                fprintf(
+                    stderr, "[%zu/%zu] %s %s %lld\n", done + 1, cases,
+                    name.c_str(), DistributionName(d), n);
+                auto result = Run(*algo, d, n, options);
+                PrintCase(out, name, d, n, result, ++done == cases);
+                fflush(out);
+            }
+        }
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+}
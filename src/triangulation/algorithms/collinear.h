@@ -0,0 +1,32 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace triangulation {
+
+// the triangulation of points all lying on one line: the path through them
+// from one end to the other, of coinciding points the first one in `pts`
+inline std::vector<IdEdge> CollinearEdges(std::vector<PointRef> &pts) {
+    std::stable_sort(
+        begin(pts), end(pts), [](const PointRef &l, const PointRef &r) {
+            return std::tie(l.point(0), l.point(1)) <
+                   std::tie(r.point(0), r.point(1));
+        });
+    std::vector<IdEdge> result;
+    size_t last = 0;
+    for (size_t i = 1; i < pts.size(); ++i) {
+        if (pts[i].point == pts[last].point) {
+            continue;
+        }
+        Index a = pts[last].id, b = pts[i].id;
+        result.push_back(a < b ? IdEdge{a, b} : IdEdge{b, a});
+        last = i;
+    }
+    return result;
+}
+
+} // namespace triangulation
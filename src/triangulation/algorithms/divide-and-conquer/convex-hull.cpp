@@ -2,22 +2,29 @@
 
 #include "triangulation/utility.h"
 
+#include <stdint.h>
+
 namespace triangulation::divide_and_conquer {
 
-using Node = ConvexHull::Node;
+template <typename T>
+using Node = typename ConvexHull<T>::Node;
 
 namespace {
 
-std::pair<Node *, Node *> LeftAndRight(Node *n1, Node *n2, Node *n3) {
-    Node *temp[3]{n1, n2, n3};
-    std::sort(temp, temp + 3, [](Node *const l, Node *const r) {
-        return l->X() < r->X();
-    });
-    return std::make_pair(temp[0], temp[2]);
+// the orders of a vertical and of a horizontal seam
+template <typename T>
+bool LeftOf(const Node<T> *l, const Node<T> *r) {
+    return l->X() < r->X() or (l->X() == r->X() and l->Y() < r->Y());
+}
+template <typename T>
+bool Below(const Node<T> *l, const Node<T> *r) {
+    return l->Y() < r->Y() or (l->Y() == r->Y() and l->X() > r->X());
 }
 
-void ArrangeThreeNodes(Node *n1, Node *n2, Node *n3) {
-    if (ComputeOrientation(n1->PrimPoint(), n2->PrimPoint(), n3->PrimPoint()) ==
+template <typename T>
+void ArrangeThreeNodes(Node<T> *n1, Node<T> *n2, Node<T> *n3) {
+    if (CoordinateTraits<T>::Orient(
+            n1->PrimPoint(), n2->PrimPoint(), n3->PrimPoint()) ==
         Orientation::kCounterClockwise) {
         n1->SetNext(n2);
         n2->SetNext(n3);
@@ -29,8 +36,9 @@ void ArrangeThreeNodes(Node *n1, Node *n2, Node *n3) {
     }
 }
 
-Node *TraceNodeBackWhen(Node *n, Node *nref, Orientation o) {
-    for (; ComputeOrientation(
+template <typename T>
+Node<T> *TraceNodeBackWhen(Node<T> *n, Node<T> *nref, Orientation o) {
+    for (; CoordinateTraits<T>::Orient(
                n->PrimPoint(), nref->PrimPoint(), n->prev->PrimPoint()) == o;
          n = n->prev) {
         // LOGF("%lld", n->Pid());
@@ -40,8 +48,9 @@ Node *TraceNodeBackWhen(Node *n, Node *nref, Orientation o) {
     return n;
 }
 
-Node *TraceNodeForwardWhen(Node *n, Node *nref, Orientation o) {
-    for (; ComputeOrientation(
+template <typename T>
+Node<T> *TraceNodeForwardWhen(Node<T> *n, Node<T> *nref, Orientation o) {
+    for (; CoordinateTraits<T>::Orient(
                n->PrimPoint(), nref->PrimPoint(), n->next->PrimPoint()) == o;
          n = n->next) {
         continue;
@@ -49,25 +58,29 @@ Node *TraceNodeForwardWhen(Node *n, Node *nref, Orientation o) {
     return n;
 }
 
-void ReleaseLinkBetween(Node *back, Node *front) {
+template <typename T>
+void ReleaseLinkBetween(
+    typename ConvexHull<T>::NodePool &pool, Node<T> *back, Node<T> *front) {
     if (back->next == front) {
         return;
     }
     front->prev->next = nullptr;
     front->prev = nullptr;
-    Node* pending = back->next;
+    Node<T> *pending = back->next;
     back->next = nullptr;
-    Node::ReleaseForward(pending);
+    pool.ReleaseForward(pending);
 }
 
-std::pair<Node *, Node *> FindBottomEdge(Node *left, Node *right) {
+template <typename T>
+std::pair<Node<T> *, Node<T> *> FindBottomEdge(Node<T> *left, Node<T> *right) {
     bool left_change = false, right_change = false;
     do {
-        Node *new_left = TraceNodeBackWhen(left, right, kClockwise);
+        Node<T> *new_left = TraceNodeBackWhen<T>(left, right, kClockwise);
         left_change = new_left != left;
         left = new_left;
 
-        Node *new_right = TraceNodeForwardWhen(right, left, kCounterClockwise);
+        Node<T> *new_right =
+            TraceNodeForwardWhen<T>(right, left, kCounterClockwise);
         right_change = new_right != right;
         right = new_right;
     } while (left_change or right_change);
@@ -75,48 +88,90 @@ std::pair<Node *, Node *> FindBottomEdge(Node *left, Node *right) {
     return std::make_pair(left, right);
 }
 
-std::pair<Node *, Node *> FindTopEdge(Node *left, Node *right) {
-    auto [r, l] = FindBottomEdge(right, left);
+template <typename T>
+std::pair<Node<T> *, Node<T> *> FindTopEdge(Node<T> *left, Node<T> *right) {
+    auto [r, l] = FindBottomEdge<T>(right, left);
     return std::make_pair(l, r);
 }
 
 } // namespace
 
-ConvexHull ConvexHull::From2Points(PointPtr p1, PointPtr p2) {
-    Node *n1 = Node::FromPoint(p1);
-    Node *n2 = Node::FromPoint(p2);
+template <typename T>
+ConvexHull<T> ConvexHull<T>::From2Points(
+    NodePool &pool, const BasicPointStore<T> &pts, Vertex p1, Vertex p2) {
+    Node *n1 = pool.New(pts, p1);
+    Node *n2 = pool.New(pts, p2);
     n1->SetNext(n2);
     n2->SetNext(n1);
-    if (p1->X() < p2->X()) {
-        return ConvexHull{n1, n2};
-    }
-    return ConvexHull{n1, n2};
+    return Extremes({n1, n2});
 }
 
-ConvexHull ConvexHull::From3Points(PointPtr p1, PointPtr p2, PointPtr p3) {
-    Node *n1 = Node::FromPoint(p1);
-    Node *n2 = Node::FromPoint(p2);
-    Node *n3 = Node::FromPoint(p3);
-    ArrangeThreeNodes(n1, n2, n3);
-    auto [left, right] = LeftAndRight(n1, n2, n3);
-    return ConvexHull{left, right};
+template <typename T>
+ConvexHull<T> ConvexHull<T>::From3Points(
+    NodePool &pool, const BasicPointStore<T> &pts, Vertex p1, Vertex p2,
+    Vertex p3) {
+    Node *n1 = pool.New(pts, p1);
+    Node *n2 = pool.New(pts, p2);
+    Node *n3 = pool.New(pts, p3);
+    ArrangeThreeNodes<T>(n1, n2, n3);
+    return Extremes({n1, n2, n3});
 }
 
-std::tuple<ConvexHull, EdgeRef, EdgeRef>
-ConvexHull::Merge(ConvexHull &left, ConvexHull &right) {
-    auto [bot_left, bot_right] =
-        FindBottomEdge(left.right_most, right.left_most);
-    auto [top_left, top_right] = FindTopEdge(left.right_most, right.left_most);
-    ConvexHull result = {left.left_most, right.right_most};
-    ReleaseLinkBetween(bot_left, top_left);
-    ReleaseLinkBetween(top_right, bot_right);
+// The tangent walks only look at orientations, which turning the plane
+// keeps, so a horizontal seam merges like a vertical one once the walks
+// start from the nodes next to it.
+template <typename T>
+std::tuple<ConvexHull<T>, HullEdge, HullEdge> ConvexHull<T>::Merge(
+    NodePool &pool, ConvexHull &left, ConvexHull &right, Seam seam) {
+    Node *left_inner = left.right_most, *right_inner = right.left_most;
+    if (seam == Seam::kHorizontal) {
+        left_inner = left.top_most;
+        right_inner = right.bottom_most;
+    }
+    auto [bot_left, bot_right] = FindBottomEdge<T>(left_inner, right_inner);
+    auto [top_left, top_right] = FindTopEdge<T>(left_inner, right_inner);
+    // the extremes of the union are extremes of one of the hulls, and
+    // survive the merge
+    ConvexHull result = Extremes(
+        {left.left_most, left.right_most, left.bottom_most, left.top_most,
+         right.left_most, right.right_most, right.bottom_most,
+         right.top_most});
+    if (bot_left == top_left and bot_right == top_right) {
+        // Both tangents are the same edge, so every point lies on one line
+        // and every node stays. The hulls are joined the way From3Points
+        // leaves collinear points, from the first point of the line
+        // straight to the last one and back over all the others.
+        ConvexHull *first = &left, *last = &right;
+        if (LeftOf<T>(right.left_most, left.left_most)) {
+            std::swap(first, last);
+        }
+        first->left_most->SetNext(last->right_most);
+        last->left_most->SetNext(first->right_most);
+        left.Invalidate();
+        right.Invalidate();
+        HullEdge edge{bot_left->vertex, bot_right->vertex};
+        return std::make_tuple(result, edge, edge);
+    }
+    ReleaseLinkBetween<T>(pool, bot_left, top_left);
+    ReleaseLinkBetween<T>(pool, top_right, bot_right);
     bot_left->SetNext(bot_right);
     top_right->SetNext(top_left);
     left.Invalidate();
     right.Invalidate();
     return std::make_tuple(
-        result, EdgeRef{bot_left->point, bot_right->point},
-        EdgeRef{top_left->point, top_right->point});
+        result, HullEdge{bot_left->vertex, bot_right->vertex},
+        HullEdge{top_left->vertex, top_right->vertex});
+}
+
+template <typename T>
+ConvexHull<T> ConvexHull<T>::Extremes(std::initializer_list<Node *> nodes) {
+    auto by_x = std::minmax(nodes, LeftOf<T>);
+    auto by_y = std::minmax(nodes, Below<T>);
+    return ConvexHull{by_x.first, by_x.second, by_y.first, by_y.second};
 }
 
+template struct ConvexHull<double>;
+template struct ConvexHull<float>;
+template struct ConvexHull<int32_t>;
+
 } // namespace triangulation::divide_and_conquer
\ No newline at end of file
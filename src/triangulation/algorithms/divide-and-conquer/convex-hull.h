@@ -1,35 +1,61 @@
 #pragma once
 
+#include "triangulation/coordinate-traits.h"
+#include "triangulation/point-store.h"
 #include "triangulation/types.h"
 #include "triangulation/utility.h"
 
+#include <algorithm>
+#include <initializer_list>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 namespace triangulation {
 
 namespace divide_and_conquer {
 
+using Vertex = PointStore::Vertex;
+
+// an edge between two vertices of a PointStore
+struct HullEdge {
+    Vertex p1, p2;
+};
+
+// The line separating the two hulls of a merge. Every point of the left
+// hull comes before every point of the right one, from left to right for a
+// vertical seam, and from bottom to top for a horizontal one, in which case
+// the left hull is the lower one. Ties go to the lower point on a vertical
+// seam and to the point further right on a horizontal one, which is the
+// order of a vertical seam turned a quarter clockwise.
+enum class Seam { kVertical, kHorizontal };
+
+// the hull of the vertices of a BasicPointStore<T>, instantiated for the
+// coordinate types of CoordinateTraits
+template <typename T>
 struct ConvexHull {
+    // a copy of the coordinates of its vertex keeps the hull walks of a
+    // merge within the nodes
     struct Node {
-        Node(const PointRef *point)
-            : point(point), prev(nullptr), next(nullptr) {}
+        Node(Vertex vertex = PointStore::kNoVertex, T x = 0, T y = 0)
+            : vertex(vertex), x(x), y(y), prev(nullptr), next(nullptr) {}
 
-        PointPtr point;
+        Vertex vertex;
+        T x, y;
         Node *prev; // first node (point) going clockwise
         Node *next; // first node (point) going counter-clockwise
 
-        double X() const {
-            return point->X();
+        T X() const {
+            return x;
         }
-        double Y() const {
-            return point->Y();
+        T Y() const {
+            return y;
         }
         Index Pid() const {
-            return point->id;
+            return vertex;
         }
-        const Point2D &PrimPoint() const {
-            return point->point;
+        Point2D PrimPoint() const {
+            return Point2D(double(x), double(y));
         }
 
         void SetNext(Node *that) {
@@ -37,60 +63,125 @@ struct ConvexHull {
             that->SetPrevImpl(this);
         }
 
-        static void ReleaseForward(Node *n) {
+      private:
+        void SetNextImpl(Node *new_next) {
+            if (next != nullptr) {
+                next->prev = nullptr;
+            }
+            next = new_next;
+        }
+        void SetPrevImpl(Node *new_prev) {
+            if (prev != nullptr) {
+                prev->next = nullptr;
+            }
+            prev = new_prev;
+        }
+    };
+
+    // Hands out hull nodes from blocks of contiguous memory. Released nodes
+    // go to a free list for reuse, the blocks themselves are only freed
+    // together with the pool at the end of a triangulation run.
+    struct NodePool {
+        static constexpr Index kBlockSize = 4096;
+
+        // `capacity` is the size of the first block, the number of points
+        // is enough for a whole divide-and-conquer run
+        NodePool(Index capacity = kBlockSize)
+            : next_block_size_(std::max(capacity, Index{1})) {}
+
+        Node *New(const BasicPointStore<T> &pts, Vertex v) {
+            ++allocated_;
+            Node *n = free_;
+            if (n != nullptr) {
+                free_ = n->next;
+            } else {
+                if (used_ == block_size_) {
+                    Grow();
+                }
+                n = &blocks_.back()[used_++];
+            }
+            *n = Node(v, pts.X(v), pts.Y(v));
+            return n;
+        }
+
+        void Release(Node *n) {
+            LOGF("release %lld in hull", n->Pid());
+            ++released_;
+            n->prev = nullptr;
+            n->next = free_;
+            free_ = n;
+        }
+
+        void ReleaseForward(Node *n) {
             assert(n != nullptr);
             auto start = n;
             auto cur = start;
             do {
                 auto next = cur->next;
-                LOGF("release %lld in hull", cur->Pid());
-                delete cur;
+                Release(cur);
                 cur = next;
             } while (cur != nullptr and cur != start);
         }
-        static void ReleaseBackward(Node *n) {
+        void ReleaseBackward(Node *n) {
             assert(n != nullptr);
             auto start = n;
             auto cur = start;
             do {
                 auto prev = cur->prev;
-                delete cur;
+                Release(cur);
                 cur = prev;
             } while (cur != nullptr and cur != start);
         }
-        static Node *FromPoint(PointPtr p) {
-            return new Node(p);
+
+        // heap allocations made for nodes so far
+        Index Blocks() const {
+            return blocks_.size();
+        }
+        Index Allocated() const {
+            return allocated_;
+        }
+        Index Released() const {
+            return released_;
         }
 
       private:
-        void SetNextImpl(Node *new_next) {
-            if (next != nullptr) {
-                next->prev = nullptr;
-            }
-            next = new_next;
-        }
-        void SetPrevImpl(Node *new_prev) {
-            if (prev != nullptr) {
-                prev->next = nullptr;
-            }
-            prev = new_prev;
+        void Grow() {
+            block_size_ = next_block_size_;
+            next_block_size_ = kBlockSize;
+            blocks_.push_back(std::make_unique<Node[]>(block_size_));
+            used_ = 0;
         }
+
+        std::vector<std::unique_ptr<Node[]>> blocks_;
+        Index block_size_ = 0;
+        Index used_ = 0;
+        Index next_block_size_;
+        Node *free_ = nullptr;
+        Index allocated_ = 0;
+        Index released_ = 0;
     };
 
-    static ConvexHull From2Points(PointPtr p1, PointPtr p2);
+    static ConvexHull From2Points(
+        NodePool &pool, const BasicPointStore<T> &pts, Vertex p1, Vertex p2);
 
-    static ConvexHull From3Points(PointPtr p1, PointPtr p2, PointPtr p3);
+    static ConvexHull From3Points(
+        NodePool &pool, const BasicPointStore<T> &pts, Vertex p1, Vertex p2,
+        Vertex p3);
 
-    static std::tuple<ConvexHull, EdgeRef, EdgeRef>
-    Merge(ConvexHull &left, ConvexHull &right);
+    // the bottom edge goes from the left hull to the right one, with both
+    // hulls below it when turned so that `seam` is vertical, the top edge
+    // likewise with both hulls above it
+    static std::tuple<ConvexHull, HullEdge, HullEdge> Merge(
+        NodePool &pool, ConvexHull &left, ConvexHull &right,
+        Seam seam = Seam::kVertical);
 
     bool Valid() const {
         return left_most != nullptr and right_most != nullptr;
     }
 
-    void Destruct() {
+    void Destruct(NodePool &pool) {
         if (Valid()) {
-            Node::ReleaseForward(left_most);
+            pool.ReleaseForward(left_most);
         }
     }
 
@@ -100,19 +191,27 @@ struct ConvexHull {
         Node* start = left_most;
         Node* next = start->next;
         do {
-            f(EdgeRef{start->point, next->point});
+            f(HullEdge{start->vertex, next->vertex});
             start = next;
             next = next->next;
         } while (start != left_most);
     }
 
+    // the first and the last node in the order of a vertical seam, and of
+    // a horizontal one
     Node *left_most;
     Node *right_most;
+    Node *bottom_most;
+    Node *top_most;
 
   private:
+    static ConvexHull Extremes(std::initializer_list<Node *> nodes);
+
     void Invalidate() {
         left_most = nullptr;
         right_most = nullptr;
+        bottom_most = nullptr;
+        top_most = nullptr;
     }
 };
 
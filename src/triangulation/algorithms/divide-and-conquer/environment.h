@@ -1,5 +1,10 @@
 #pragma once
 
+#include "triangulation/algorithms/divide-and-conquer/convex-hull.h"
+#include "triangulation/algorithms/divide-and-conquer/quad-edge.h"
+#include "triangulation/coordinate-traits.h"
+#include "triangulation/point-store.h"
+#include "triangulation/stats.h"
 #include "triangulation/types.h"
 #include "triangulation/utility.h"
 
@@ -10,78 +15,168 @@ namespace triangulation {
 
 namespace divide_and_conquer {
 
+using Edge = QuadEdgeMesh::Edge;
+using Shard = QuadEdgeMesh::Shard;
+
+// The points and the mesh over them, vertex i being the i-th point in the
+// order the recursion halves them, from left to right for vertical cuts.
+// The coordinates are kept as T, see CoordinateTraits.
+template <typename T>
 struct Environment {
   public:
-    Environment(const std::vector<PointRef> &pts)
-        : pts_(pts), edges_(pts.size()) {}
+    // copies the points in the given order, vertex v being pts[order[v]];
+    // `pts` can be released afterwards
+    Environment(
+        const std::vector<PointRef> &pts, const std::vector<Vertex> &order)
+        : pts_(pts, order), mesh_(pts_.Size()) {}
+
+    // no points yet, for an environment that is Assign'ed many in turn
+    Environment() = default;
+
+    Environment(const Environment &) = delete;
+    Environment &operator=(const Environment &) = delete;
+
+    // starts over with new points as the constructor would, keeping the
+    // capacity of the points and of the mesh
+    void Assign(
+        const std::vector<PointRef> &pts, const std::vector<Vertex> &order) {
+        pts_.Assign(pts, order);
+        mesh_.Reset(pts_.Size());
+    }
+
+    Index PointSize() const {
+        return pts_.Size();
+    }
+
+    const BasicPointStore<T> &Points() const {
+        return pts_;
+    }
 
-    int64_t PointSize() const {
-        return pts_.size();
+    Point2D GetPoint(Vertex v) const {
+        return pts_.Point(v);
     }
 
-    PointPtr GetPointByIndex(int64_t i) const {
-        return &pts_[i];
+    QuadEdgeMesh &Mesh() {
+        return mesh_;
     }
 
-    std::vector<const PointRef *> &GetEdges(Index i) {
-        return edges_.at(i);
+    // inserts p1 - p2 into the rotation of both end points, returning the
+    // edge going from p1 to p2, or kNoEdge if they are already connected
+    Edge AddEdge(Shard &shard, Vertex p1, Vertex p2) {
+        LOGF("Adding edge %lld, %lld", pts_.Id(p1), pts_.Id(p2));
+        if (mesh_.FindEdge(p1, p2) != QuadEdgeMesh::kNoEdge) {
+            return QuadEdgeMesh::kNoEdge;
+        }
+        Edge slot1 = mesh_.FindSlot(pts_, p1, p2),
+             slot2 = mesh_.FindSlot(pts_, p2, p1);
+        Edge e = mesh_.MakeEdge(shard, p1, p2);
+        if (slot1 != QuadEdgeMesh::kNoEdge) {
+            mesh_.Splice(slot1, e);
+        }
+        if (slot2 != QuadEdgeMesh::kNoEdge) {
+            mesh_.Splice(slot2, QuadEdgeMesh::Sym(e));
+        }
+        STATS_COUNT(kEdgesAdded);
+        return e;
     }
 
-    bool AddEdge(PointPtr p1, PointPtr p2) {
-        LOGF("Adding edge %lld, %lld", p1->id, p2->id);
-        bool ij = AddEdgeImpl(p1->id, p2);
-        bool ji = AddEdgeImpl(p2->id, p1);
-        assert(ij == ji);
-        return ij and ji;
+    Edge AddEdge(Shard &shard, HullEdge edge) {
+        return AddEdge(shard, edge.p1, edge.p2);
     }
 
-    bool AddEdge(EdgeRef edge) {
-        return AddEdge(edge.p1, edge.p2);
+    // new edge from a.Dest to b.Org closing the face on the left of a and b
+    Edge Connect(Shard &shard, Edge a, Edge b) {
+        Edge e = mesh_.Connect(shard, a, b);
+        STATS_COUNT(kEdgesAdded);
+        LOGF(
+            "Adding edge %lld, %lld", pts_.Id(mesh_.Org(e)),
+            pts_.Id(mesh_.Dest(e)));
+        return e;
     }
 
-    bool RemoveEdge(PointPtr p1, PointPtr p2) {
-        LOGF("Removing edge %lld, %lld\n", p1->id, p2->id);
-        bool ij = RemoveEdgeImpl(p1->id, p2);
-        bool ji = RemoveEdgeImpl(p2->id, p1);
-        assert(ij == ji);
-        return ij and ji;
+    void RemoveEdge(Shard &shard, Edge e) {
+        LOGF(
+            "Removing edge %lld, %lld", pts_.Id(mesh_.Org(e)),
+            pts_.Id(mesh_.Dest(e)));
+        mesh_.DeleteEdge(shard, e);
+        STATS_COUNT(kEdgesRemoved);
     }
 
     std::vector<IdEdge> Edges() const {
         std::vector<IdEdge> result;
-        result.reserve(edges_.size() / 2 + 1);
-        for (int i = 0; i < edges_.size(); ++i) {
-            for (const PointRef *p2 : edges_[i]) {
-                if (i < p2->id) {
-                    result.push_back(IdEdge{i, p2->id});
-                }
+        result.reserve(pts_.Size() * 3);
+        CollectEdges(result);
+        return result;
+    }
+
+    // Edges into `result`, replacing what it held
+    void CollectEdges(std::vector<IdEdge> &result) const {
+        STATS_PHASE(kCollectEdges);
+        result.clear();
+        for (Edge q = 0; q < mesh_.QuadSize(); ++q) {
+            Edge e = q * 4;
+            if (mesh_.Alive(e)) {
+                Index i = pts_.Id(mesh_.Org(e)), j = pts_.Id(mesh_.Dest(e));
+                result.push_back(i < j ? IdEdge{i, j} : IdEdge{j, i});
             }
         }
+    }
+
+    // The faces on the left of the directed edges e, Lnext(e) and
+    // Lnext(Lnext(e)) closing up counter-clockwise are the triangles, the
+    // outer face runs clockwise. Directed edge e maps to slot e / 2.
+    std::vector<IdTriangle> Triangles() {
+        std::vector<IdTriangle> result;
+        CollectTriangles(result);
         return result;
     }
 
-  private:
-    bool AddEdgeImpl(Index i, const PointRef *p) {
-        for (const PointRef *point : edges_[i]) {
-            if (point == p) return false;
+    // Triangles into `result`, replacing what it held; the scratch space
+    // stays with the environment for the next call
+    void CollectTriangles(std::vector<IdTriangle> &result) {
+        STATS_PHASE(kCollectEdges);
+        auto &face = face_;
+        auto &first = first_;
+        face.assign(mesh_.QuadSize() * 2, kNoNeighbor);
+        first.clear();
+        first.reserve(pts_.Size() * 2);
+        for (Edge e = 0; e < mesh_.QuadSize() * 4; e += 2) {
+            if (face[e >> 1] != kNoNeighbor or not mesh_.Alive(e)) {
+                continue;
+            }
+            Edge e1 = mesh_.Lnext(e), e2 = mesh_.Lnext(e1);
+            if (mesh_.Lnext(e2) != e or
+                CoordinateTraits<T>::Orient(
+                    GetPoint(mesh_.Org(e)), GetPoint(mesh_.Org(e1)),
+                    GetPoint(mesh_.Org(e2))) != kCounterClockwise) {
+                continue;
+            }
+            face[e >> 1] = face[e1 >> 1] = face[e2 >> 1] = first.size();
+            first.push_back(e);
         }
-        edges_.at(i).push_back(p);
-        return true;
-    }
-    bool RemoveEdgeImpl(Index i, const PointRef *j) {
-        for (auto it = begin(edges_[i]); it != end(edges_[i]); ++it) {
-            if (*it == j) {
-                edges_.at(i).erase(it);
-                return true;
+        result.resize(first.size());
+        for (size_t t = 0; t < first.size(); ++t) {
+            Edge e = first[t];
+            // the edge leaving corner k + 1 is opposite corner k
+            for (int k = 0; k < 3; ++k) {
+                Edge next = mesh_.Lnext(e);
+                result[t].vertices[k] = pts_.Id(mesh_.Org(e));
+                result[t].neighbors[(k + 2) % 3] =
+                    face[QuadEdgeMesh::Sym(e) >> 1];
+                e = next;
             }
         }
-        return false;
     }
 
-    const std::vector<PointRef> &pts_;
-    std::vector<std::vector<const PointRef *>> edges_;
+  private:
+    BasicPointStore<T> pts_;
+    QuadEdgeMesh mesh_;
+
+    // scratch space of CollectTriangles
+    std::vector<Index> face_;
+    std::vector<Edge> first_;
 };
 
 } // namespace divide_and_conquer
 
-} // namespace triangulation
\ No newline at end of file
+} // namespace triangulation
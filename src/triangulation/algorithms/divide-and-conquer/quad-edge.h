@@ -0,0 +1,264 @@
+#pragma once
+
+#include "triangulation/coordinate-traits.h"
+#include "triangulation/point-store.h"
+#include "triangulation/types.h"
+#include "triangulation/utility.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+namespace divide_and_conquer {
+
+// Guibas-Stolfi quad-edge topology over the primal edges only.
+//
+// A directed edge is encoded as `4 * quad + rotation`, so Rot/Sym/InvRot are
+// bit operations and the whole mesh lives in two flat arrays. Every edge
+// knows its counter-clockwise successor around its origin (Onext), which
+// gives the ordered rotation around a vertex for free. Edge origins are
+// vertices of a BasicPointStore, which the mesh itself never looks at; the
+// few operations needing coordinates take the store as an argument.
+struct QuadEdgeMesh {
+    using Edge = uint32_t;
+    using Vertex = PointStore::Vertex;
+    static constexpr Edge kNoEdge = ~Edge(0);
+    static constexpr Vertex kNoVertex = PointStore::kNoVertex;
+
+    // A planar graph over k points never holds more than 3k - 6 edges, so
+    // the points [i, j) of the sorted input own the quads [3i, 3j). A shard
+    // hands out the quads of such a range: the untouched ones from
+    // [cursor, end) and the deleted ones from a free list threaded through
+    // the mesh. Subproblems on disjoint point ranges use disjoint shards and
+    // can build their part of the mesh concurrently.
+    struct Shard {
+        Edge cursor = 0, end = 0;
+        Edge free_head = kNoEdge, free_tail = kNoEdge;
+    };
+
+    static constexpr Index kQuadsPerVertex = 3;
+    // the most vertices a mesh is sized for, every edge of theirs numbered
+    // below kNoEdge
+    static constexpr Index kMaxVertices = kNoEdge / (kQuadsPerVertex * 4);
+
+    explicit QuadEdgeMesh(Index vertices = 0) {
+        Reset(vertices);
+    }
+
+    // drops every edge and sizes the mesh for `vertices` points, keeping
+    // the capacity of the arrays
+    void Reset(Index vertices) {
+        assert(vertices <= kMaxVertices);
+        next_.assign(vertices * kQuadsPerVertex * 4, kNoEdge);
+        org_.assign(vertices * kQuadsPerVertex * 2, kNoVertex);
+        vertex_edge_.assign(vertices, kNoEdge);
+    }
+
+    Shard Whole() const {
+        return Shard{0, Edge(next_.size())};
+    }
+
+    // gives the quads of the vertices from `vertex` on to a new shard,
+    // `shard` must not have handed any of them out yet
+    Shard Split(Shard &shard, Index vertex) const {
+        Edge mid = vertex * kQuadsPerVertex * 4;
+        assert(shard.cursor <= mid and mid <= shard.end);
+        Shard result{mid, shard.end};
+        shard.end = mid;
+        return result;
+    }
+
+    // takes back everything `other` did not use, `other` must come from
+    // splitting `shard`
+    void Absorb(Shard &shard, Shard &other) {
+        for (Edge q = shard.cursor; q < shard.end; q += 4) {
+            Free(shard, q);
+        }
+        if (other.free_head != kNoEdge) {
+            if (shard.free_head == kNoEdge) {
+                shard.free_head = other.free_head;
+            } else {
+                next_[shard.free_tail] = other.free_head;
+            }
+            shard.free_tail = other.free_tail;
+        }
+        shard.cursor = other.cursor;
+        shard.end = other.end;
+        other = Shard{};
+    }
+
+    static Edge Rot(Edge e) {
+        return (e & ~Edge(3)) | ((e + 1) & 3);
+    }
+    static Edge Sym(Edge e) {
+        return (e & ~Edge(3)) | ((e + 2) & 3);
+    }
+    static Edge InvRot(Edge e) {
+        return (e & ~Edge(3)) | ((e + 3) & 3);
+    }
+
+    Edge Onext(Edge e) const {
+        return next_[e];
+    }
+    Edge Oprev(Edge e) const {
+        return Rot(Onext(Rot(e)));
+    }
+    Edge Lnext(Edge e) const {
+        return Rot(Onext(InvRot(e)));
+    }
+
+    Vertex Org(Edge e) const {
+        return org_[e >> 1];
+    }
+    Vertex Dest(Edge e) const {
+        return Org(Sym(e));
+    }
+
+    // any edge leaving `v`, kNoEdge for isolated vertices
+    Edge VertexEdge(Vertex v) const {
+        return vertex_edge_[v];
+    }
+
+    bool Alive(Edge e) const {
+        return Org(e) != kNoVertex;
+    }
+
+    // number of quad-edge slots, including the ones deleted
+    Edge QuadSize() const {
+        return next_.size() / 4;
+    }
+
+    Edge MakeEdge(Shard &shard, Vertex org, Vertex dest) {
+        Edge e = shard.free_head;
+        if (e != kNoEdge) {
+            shard.free_head = next_[e];
+            if (shard.free_head == kNoEdge) {
+                shard.free_tail = kNoEdge;
+            }
+        } else {
+            assert(shard.cursor < shard.end);
+            e = shard.cursor;
+            shard.cursor += 4;
+        }
+        next_[e] = e;
+        next_[e + 1] = e + 3;
+        next_[e + 2] = e + 2;
+        next_[e + 3] = e + 1;
+        org_[e >> 1] = org;
+        org_[(e >> 1) + 1] = dest;
+        Attach(e);
+        Attach(Sym(e));
+        return e;
+    }
+
+    void Splice(Edge a, Edge b) {
+        Edge alpha = Rot(Onext(a)), beta = Rot(Onext(b));
+        Edge t1 = Onext(b), t2 = Onext(a), t3 = Onext(beta),
+             t4 = Onext(alpha);
+        next_[a] = t1;
+        next_[b] = t2;
+        next_[alpha] = t3;
+        next_[beta] = t4;
+    }
+
+    // new edge from a.Dest to b.Org, sharing the left face of a and b
+    Edge Connect(Shard &shard, Edge a, Edge b) {
+        Edge e = MakeEdge(shard, Dest(a), Org(b));
+        Splice(e, Lnext(a));
+        Splice(Sym(e), b);
+        return e;
+    }
+
+    void DeleteEdge(Shard &shard, Edge e) {
+        Detach(e);
+        Detach(Sym(e));
+        Splice(e, Oprev(e));
+        Splice(Sym(e), Oprev(Sym(e)));
+        e &= ~Edge(3);
+        org_[e >> 1] = kNoVertex;
+        org_[(e >> 1) + 1] = kNoVertex;
+        Free(shard, e);
+    }
+
+    // the edge leaving `v` after which direction `t` falls in
+    // counter-clockwise order, kNoEdge when `v` has no edges yet
+    template <typename T>
+    Edge FindSlot(const BasicPointStore<T> &pts, Vertex v, Vertex t) const {
+        Edge start = VertexEdge(v);
+        if (start == kNoEdge or Onext(start) == start) {
+            return start;
+        }
+        Edge e = start;
+        do {
+            if (InWedge(pts, v, Dest(e), Dest(Onext(e)), t)) {
+                return e;
+            }
+            e = Onext(e);
+        } while (e != start);
+        return start;
+    }
+
+    // the edge from `v` to `t`, kNoEdge if they are not connected
+    Edge FindEdge(Vertex v, Vertex t) const {
+        Edge start = VertexEdge(v);
+        if (start == kNoEdge) {
+            return kNoEdge;
+        }
+        Edge e = start;
+        do {
+            if (Dest(e) == t) {
+                return e;
+            }
+            e = Onext(e);
+        } while (e != start);
+        return kNoEdge;
+    }
+
+  private:
+    // whether `t` lies strictly inside the counter-clockwise sweep from
+    // direction `a` to direction `b` around `v`
+    template <typename T>
+    static bool InWedge(
+        const BasicPointStore<T> &pts, Vertex v, Vertex a, Vertex b,
+        Vertex t) {
+        using Traits = CoordinateTraits<T>;
+        Point2D pv = pts.Point(v), pa = pts.Point(a), pb = pts.Point(b),
+                pt = pts.Point(t);
+        bool after_a = Traits::Orient(pv, pa, pt) == kCounterClockwise;
+        bool before_b = Traits::Orient(pv, pt, pb) == kCounterClockwise;
+        if (Traits::Orient(pv, pa, pb) == kCounterClockwise) {
+            return after_a and before_b;
+        }
+        return after_a or before_b;
+    }
+
+    void Free(Shard &shard, Edge q) {
+        next_[q] = shard.free_head;
+        shard.free_head = q;
+        if (shard.free_tail == kNoEdge) {
+            shard.free_tail = q;
+        }
+    }
+
+    void Attach(Edge e) {
+        Edge &slot = vertex_edge_[Org(e)];
+        if (slot == kNoEdge) {
+            slot = e;
+        }
+    }
+    void Detach(Edge e) {
+        Edge &slot = vertex_edge_[Org(e)];
+        if (slot == e) {
+            slot = Onext(e) == e ? kNoEdge : Onext(e);
+        }
+    }
+
+    std::vector<Edge> next_;
+    std::vector<Vertex> org_;
+    std::vector<Edge> vertex_edge_;
+};
+
+} // namespace divide_and_conquer
+
+} // namespace triangulation
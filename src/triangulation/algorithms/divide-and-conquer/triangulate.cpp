@@ -2,13 +2,20 @@
 
 #include "triangulation/algorithms/divide-and-conquer/convex-hull.h"
 #include "triangulation/algorithms/divide-and-conquer/environment.h"
+#include "triangulation/batch-predicates.h"
+#include "triangulation/coordinate-traits.h"
+#include "triangulation/parallel/radix-sort.h"
+#include "triangulation/parallel/work-stealing-pool.h"
+#include "triangulation/stats.h"
 #include "triangulation/utility.h"
 
 #include <algorithm>
 #include <chrono>
+#include <memory>
 #include <optional>
 #include <stdio.h>
 #include <tuple>
+#include <type_traits>
 
 namespace triangulation {
 
@@ -17,34 +24,56 @@ using namespace std::chrono;
 
 namespace {
 
-void SortByAngle(std::vector<PointPtr> &ps, PointPtr pa, PointPtr pb) {
-    Point2D v = pb->point - pa->point;
-    std::sort(std::begin(ps), ps.end(), [&v, pa](PointPtr p1, PointPtr p2) {
-        return VecCos(p1->point - pa->point, v) >
-               VecCos(p2->point - pa->point, v);
-    });
-}
-
+#ifndef NDEBUG
 void PrintEdges(const std::vector<IdEdge> &edges) {
     LOGLN("----- Logging edges start -----");
-    for (int i = 0; i < edges.size(); ++i) {
+    for (size_t i = 0; i < edges.size(); ++i) {
         fprintf(stderr, "%d %d\n", (int)edges[i].p1, (int)edges[i].p2);
     }
     LOGLN("----- Logging edges end -----");
 }
+#endif
+
+// subproblems smaller than this are not worth a task of their own
+constexpr Index kParallelCutoff = 1 << 15;
 
 } // namespace
 
+// the triangulation over coordinates of type T, see CoordinateTraits
+template <typename T>
 struct DivideAndConquerImpl {
   public:
-    DivideAndConquerImpl(Environment &env) : env_(env) {}
+    using Hull = ConvexHull<T>;
+    using Traits = CoordinateTraits<T>;
+
+    // `pools` holds one node pool per worker of `workers`, which is null
+    // for a sequential run
+    DivideAndConquerImpl(
+        Environment<T> &env, std::vector<typename Hull::NodePool> &pools,
+        WorkStealingPool *workers, Shard shard,
+        DivideAndConquer::Cuts cuts = DivideAndConquer::Cuts::kVertical)
+        : env_(env), pools_(pools), workers_(workers), shard_(shard),
+          cuts_(cuts) {}
 
-    void Go() {
-        auto hull = Recurse(0, env_.PointSize());
-        hull.Destruct();
+    // the top merge joins [0, split) and [split, n) when both hold at
+    // least two points, the middle is taken otherwise. Every run starts
+    // over on the whole mesh, so one driver can build the triangulations
+    // of an environment reassigned in between.
+    void Go(Index split = 0) {
+        STATS_PHASE(kRecurse);
+        shard_ = env_.Mesh().Whole();
+        Index n = env_.PointSize();
+        if (n < 2) {
+            return;
+        }
+        auto hull = split >= 2 and n - split >= 2
+                        ? DivideRecurse(0, split, n, 0)
+                        : Recurse(0, n, 0);
+        hull.Destruct(Pool());
     }
 
-    ConvexHull Recurse(Index i, Index j) {
+    // `depth` counts the merges above this one, for the stats
+    Hull Recurse(Index i, Index j, int depth) {
         assert(j - i >= 2);
         if (j - i == 2) {
             return BaseCase2Points(i);
@@ -52,165 +81,565 @@ struct DivideAndConquerImpl {
         if (j - i == 3) {
             return BaseCase3Points(i);
         }
-        return DivideRecurse(i, (i + j) / 2, j);
+        return DivideRecurse(i, (i + j) / 2, j, depth);
     }
 
   private:
-    ConvexHull BaseCase2Points(int64_t i) {
-        PointPtr p1 = env_.GetPointByIndex(i);
-        PointPtr p2 = env_.GetPointByIndex(i + 1);
-        env_.AddEdge(p1, p2);
+    Hull BaseCase2Points(Index i) {
+        Vertex p1 = i, p2 = i + 1;
+        env_.AddEdge(shard_, p1, p2);
         DebugEdge();
-        return ConvexHull::From2Points(p1, p2);
-    }
-    ConvexHull BaseCase3Points(int64_t i) {
-        PointPtr p1 = env_.GetPointByIndex(i);
-        PointPtr p2 = env_.GetPointByIndex(i + 1);
-        PointPtr p3 = env_.GetPointByIndex(i + 2);
-        env_.AddEdge(p1, p2);
-        env_.AddEdge(p2, p3);
-        env_.AddEdge(p1, p3);
+        return Hull::From2Points(Pool(), env_.Points(), p1, p2);
+    }
+    Hull BaseCase3Points(Index i) {
+        Vertex p1 = i, p2 = i + 1, p3 = i + 2;
+        env_.AddEdge(shard_, p1, p2);
+        env_.AddEdge(shard_, p2, p3);
+        if (Traits::Orient(
+                env_.GetPoint(p1), env_.GetPoint(p2), env_.GetPoint(p3)) !=
+            kUnknown) {
+            env_.AddEdge(shard_, p1, p3);
+        }
         DebugEdge();
-        return ConvexHull::From3Points(p1, p2, p3);
+        return Hull::From3Points(Pool(), env_.Points(), p1, p2, p3);
     }
-    ConvexHull DivideRecurse(int64_t i, int64_t m, int64_t j) {
-        ConvexHull left_hull = Recurse(i, m);
-        ConvexHull right_hull = Recurse(m, j);
+    Hull DivideRecurse(Index i, Index m, Index j, int depth) {
+        Hull left_hull, right_hull;
+        if (workers_ != nullptr and j - i >= kParallelCutoff) {
+            // the halves touch disjoint points, and so disjoint quads
+            DivideAndConquerImpl right(
+                env_, pools_, workers_, env_.Mesh().Split(shard_, m), cuts_);
+            workers_->Invoke(
+                [&] { left_hull = Recurse(i, m, depth + 1); },
+                [&] { right_hull = right.Recurse(m, j, depth + 1); });
+            env_.Mesh().Absorb(shard_, right.shard_);
+        } else {
+            left_hull = Recurse(i, m, depth + 1);
+            right_hull = Recurse(m, j, depth + 1);
+        }
         LOGF("Merging of: %lld %lld %lld", i, m, j);
-        auto [hull, bot, top] = ConvexHull::Merge(left_hull, right_hull);
+        STATS_MERGE(depth);
+        auto [hull, bot, top] = [&] {
+            STATS_PHASE(kHullMerge);
+            return Hull::Merge(Pool(), left_hull, right_hull, SeamAt(depth));
+        }();
         LOGF(
-            "Bottom: %lld %lld, Top: %lld %lld", bot.p1->id, bot.p2->id,
-            top.p1->id, top.p2->id);
+            "Bottom: %lld %lld, Top: %lld %lld", env_.Points().Id(bot.p1),
+            env_.Points().Id(bot.p2), env_.Points().Id(top.p1),
+            env_.Points().Id(top.p2));
         LogConvexHull(hull);
-        bool add_edge_success = env_.AddEdge(bot);
-        assert(add_edge_success);
-        auto final_edge [[maybe_unused]] = MergeWithBaseEdge(bot);
+        Edge base = env_.AddEdge(shard_, bot);
+        assert(base != QuadEdgeMesh::kNoEdge);
+        STATS_PHASE(kMergeBaseEdge);
+        auto final_edge [[maybe_unused]] = MergeWithBaseEdge(base);
         // assert(final_edge == top); // must it?
         return hull;
     }
 
-    EdgeRef MergeWithBaseEdge(EdgeRef edge) {
-        PointPtr left = edge.p1, right = edge.p2;
-        PointPtr lc = GetLeftCandidate(left, right),
-                 rc = GetRightCandidate(left, right);
-        auto new_edge = DebateCandidates(left, right, lc, rc);
-        if (not new_edge) {
-            return edge;
-        }
-        env_.AddEdge(*new_edge);
-        return MergeWithBaseEdge(*new_edge);
-    }
-
-    std::vector<PointPtr>
-    GetCandidates(PointPtr pa, PointPtr pb, Orientation o) {
-        const auto &links = env_.GetEdges(pa->id);
-        std::vector<PointPtr> result;
-        for (auto p : links) {
-            if (ComputeOrientation(pa->point, pb->point, p->point) == o and
-                p != pb) {
-                result.push_back(p);
+    // Triangulates the seam upwards from `edge`, which goes from the left
+    // half to the right half with the part of the seam not yet
+    // triangulated lying above it. Every step connects a new base edge
+    // across the seam until neither side offers a candidate, and returns
+    // the last one, the upper common tangent.
+    Edge MergeWithBaseEdge(Edge edge) {
+        for (;;) {
+            Edge lc = GetLeftCandidate(edge), rc = GetRightCandidate(edge);
+            auto new_edge = DebateCandidates(edge, lc, rc);
+            if (not new_edge) {
+                return edge;
             }
+            edge = *new_edge;
         }
-        SortByAngle(result, pa, pb);
-        return result;
     }
 
-    std::vector<PointPtr> GetLeftCandidates(PointPtr left, PointPtr right) {
-        return GetCandidates(left, right, Orientation::kCounterClockwise);
-    }
-    std::vector<PointPtr> GetRightCandidates(PointPtr left, PointPtr right) {
-        return GetCandidates(right, left, Orientation::kClockwise);
+    // Neighbors of `base`'s origin on the `o` side of `base` become the
+    // first ones of ring_, and their number is returned: walking the
+    // rotation from `base` towards `o` yields them already sorted by angle.
+    // The orientation of the whole rotation is tested in one batch, the
+    // candidates are the prefix lying on the `o` side.
+    size_t GetCandidates(Edge base, Orientation o) {
+        const auto &mesh = env_.Mesh();
+        Point2D pa = env_.GetPoint(mesh.Org(base)),
+                pb = env_.GetPoint(mesh.Dest(base));
+        auto rotate = [&mesh, o](Edge e) {
+            return o == kCounterClockwise ? mesh.Onext(e) : mesh.Oprev(e);
+        };
+        ring_.clear();
+        batch_.Clear();
+        for (Edge e = rotate(base); e != base; e = rotate(e)) {
+            ring_.push_back(e);
+            batch_.Push(env_.GetPoint(mesh.Dest(e)));
+        }
+        Traits::BatchOrientation(pa, pb, batch_, signs_);
+        int8_t side = o == kCounterClockwise ? 1 : -1;
+        size_t count = 0;
+        while (count < ring_.size() and signs_[count] == side) {
+            ++count;
+        }
+        return count;
     }
 
-    PointPtr SelectCandidate(
-        const std::vector<PointPtr> &cs, PointPtr pa, PointPtr pb,
-        Orientation o) {
-        if (cs.empty()) return nullptr;
-        for (int i = 0; i < cs.size() - 1; ++i) {
-            PointPtr cur = cs[i], next = cs[i + 1];
-            if (InCircleO(pa->point, pb->point, cur->point, next->point, o)) {
-                bool remove_success = env_.RemoveEdge(pa, cur);
-                assert(remove_success);
+    // InCircleO(pa, pb, cur, next, o) for every pair of neighboring
+    // candidates, the first `count` edges of ring_, is one batch: for
+    // clockwise candidates the in-circle test takes the points in the
+    // order (pa, cur, pb, next), which flips the sign of the
+    // (pa, pb, cur, next) determinant the batch computes
+    Edge SelectCandidate(size_t count, Vertex pa, Vertex pb, Orientation o) {
+        if (count == 0) return QuadEdgeMesh::kNoEdge;
+        const auto &mesh = env_.Mesh();
+        batch_.Clear();
+        for (size_t i = 0; i < count; ++i) {
+            batch_.Push(env_.GetPoint(mesh.Dest(ring_[i])));
+        }
+        Traits::BatchInCircleOfNeighbors(
+            env_.GetPoint(pa), env_.GetPoint(pb), batch_, signs_);
+        int8_t inside = o == kCounterClockwise ? 1 : -1;
+        for (size_t i = 0; i + 1 < count; ++i) {
+            if (signs_[i] == inside) {
+                env_.RemoveEdge(shard_, ring_[i]);
             } else {
-                return cur;
+                return ring_[i];
             }
         }
-        return cs.back();
+        return ring_[count - 1];
     }
 
-    PointPtr SelectLeftCandidate(
-        const std::vector<PointPtr> &cs, PointPtr left, PointPtr right) {
-        return SelectCandidate(cs, left, right, kCounterClockwise);
+    Edge GetLeftCandidate(Edge base) {
+        const auto &mesh = env_.Mesh();
+        size_t count = GetCandidates(base, kCounterClockwise);
+        return SelectCandidate(
+            count, mesh.Org(base), mesh.Dest(base), kCounterClockwise);
     }
-    PointPtr SelectRightCandidate(
-        const std::vector<PointPtr> &cs, PointPtr left, PointPtr right) {
-        return SelectCandidate(cs, right, left, kClockwise);
+    Edge GetRightCandidate(Edge base) {
+        const auto &mesh = env_.Mesh();
+        size_t count = GetCandidates(QuadEdgeMesh::Sym(base), kClockwise);
+        return SelectCandidate(
+            count, mesh.Dest(base), mesh.Org(base), kClockwise);
     }
 
-    PointPtr GetLeftCandidate(PointPtr left, PointPtr right) {
-        auto candidates = GetLeftCandidates(left, right);
-        return SelectLeftCandidate(candidates, left, right);
-    }
-    PointPtr GetRightCandidate(PointPtr left, PointPtr right) {
-        auto candidates = GetRightCandidates(left, right);
-        return SelectRightCandidate(candidates, left, right);
-    }
-
-    static std::optional<EdgeRef>
-    DebateCandidates(PointPtr left, PointPtr right, PointPtr lc, PointPtr rc) {
-        if (lc == nullptr and rc == nullptr) {
+    // lc leaves the left end of `base` and rc leaves the right end, the
+    // winner is connected to the opposite end and becomes the next base edge
+    std::optional<Edge> DebateCandidates(Edge base, Edge lc, Edge rc) {
+        const auto &mesh = env_.Mesh();
+        Vertex left = mesh.Org(base), right = mesh.Dest(base);
+        if (lc == QuadEdgeMesh::kNoEdge and rc == QuadEdgeMesh::kNoEdge) {
             return {};
         }
-        if (rc == nullptr) {
-            return EdgeRef{lc, right};
-        }
-        if (lc == nullptr) {
-            return EdgeRef{left, rc};
+        if (rc == QuadEdgeMesh::kNoEdge) {
+            return ConnectLeftCandidate(base, lc);
         }
-        if (not InCircle(left->point, right->point, lc->point, rc->point)) {
-            return EdgeRef{lc, right};
+        if (lc == QuadEdgeMesh::kNoEdge) {
+            return ConnectRightCandidate(base, rc);
         }
-        if (not InCircle(left->point, right->point, rc->point, lc->point)) {
-            return EdgeRef{left, rc};
+        Vertex lp = mesh.Dest(lc), rp = mesh.Dest(rc);
+        // the predicate is exact, so if rc lies inside the circle of left,
+        // right and lc, then lc lies outside the one of left, right and rc
+        if (not Traits::InCircle(
+                env_.GetPoint(left), env_.GetPoint(right), env_.GetPoint(lp),
+                env_.GetPoint(rp))) {
+            return ConnectLeftCandidate(base, lc);
         }
-        assert(false); // this should never happen??
-        return {};
+        return ConnectRightCandidate(base, rc);
+    }
+
+    Edge ConnectLeftCandidate(Edge base, Edge lc) {
+        return QuadEdgeMesh::Sym(
+            env_.Connect(shard_, base, QuadEdgeMesh::Sym(lc)));
+    }
+    Edge ConnectRightCandidate(Edge base, Edge rc) {
+        return QuadEdgeMesh::Sym(env_.Connect(shard_, rc, base));
     }
 
     void DebugEdge() {
 #ifndef NDEBUG
-        PrintEdges(env_.Edges());
+        if (workers_ == nullptr) {
+            PrintEdges(env_.Edges());
+        }
 #endif
     }
 
-    void LogConvexHull(ConvexHull hull) {
-#ifdef NDEBUG
+    void LogConvexHull(Hull hull [[maybe_unused]]) {
+#ifndef NDEBUG
         LOGLN("Convex Hull:");
         LOGF(
             "left-most: %lld, right-most: %lld", hull.left_most->Pid(),
             hull.right_most->Pid());
-        hull.TraverseEdges(
-            [](EdgeRef e) { LOGF("%lld %lld", e.p1->id, e.p2->id); });
+        hull.TraverseEdges([this](HullEdge e) {
+            LOGF(
+                "%lld %lld", env_.Points().Id(e.p1), env_.Points().Id(e.p2));
+        });
 #endif
     }
 
-    Environment &env_;
+    typename Hull::NodePool &Pool() {
+        return pools_[workers_ ? workers_->WorkerIndex() : 0];
+    }
+
+    Seam SeamAt(int depth) const {
+        if (cuts_ == DivideAndConquer::Cuts::kAlternating and depth % 2 == 1) {
+            return Seam::kHorizontal;
+        }
+        return Seam::kVertical;
+    }
+
+    Environment<T> &env_;
+    std::vector<typename Hull::NodePool> &pools_;
+    WorkStealingPool *workers_;
+    Shard shard_;
+    DivideAndConquer::Cuts cuts_;
+
+    // scratch space of the batched predicates
+    std::vector<Edge> ring_;
+    PointBatch batch_;
+    std::vector<int8_t> signs_;
+};
+
+namespace {
+
+// below this many points the comparison sort beats the radix passes
+constexpr size_t kMinRadixSort = 1 << 14;
+
+} // namespace
+
+// The order of the points from left to right, ties broken from bottom to
+// top and then by index, into `order`. Large inputs are radix sorted on the
+// x keys, moving 16-byte key and index pairs around instead of the points;
+// `items` and `buffer` are the scratch space of the radix passes.
+void SortFromLeftToRight(
+    const std::vector<PointRef> &pts, WorkStealingPool *workers,
+    std::vector<Vertex> &order, std::vector<RadixItem> &items,
+    std::vector<RadixItem> &buffer) {
+    STATS_PHASE(kSort);
+    order.resize(pts.size());
+    if (pts.size() < kMinRadixSort) {
+        for (size_t i = 0; i < pts.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(begin(order), end(order), [&](Vertex l, Vertex r) {
+            return std::tie(pts[l].point(0), pts[l].point(1), l) <
+                   std::tie(pts[r].point(0), pts[r].point(1), r);
+        });
+        return;
+    }
+    items.resize(pts.size());
+    for (size_t i = 0; i < pts.size(); ++i) {
+        items[i] = {OrderedBits(pts[i].X()), Vertex(i)};
+    }
+    RadixSort(items, buffer, workers);
+    for (size_t i = 0; i < pts.size(); ++i) {
+        order[i] = items[i].index;
+    }
+    // then the runs of points sharing an x, the columns of a grid say, on y
+    for (size_t i = 0, j; i < pts.size(); i = j) {
+        j = i + 1;
+        while (j < pts.size() and items[j].key == items[i].key) {
+            ++j;
+        }
+        if (j - i > 1) {
+            std::sort(
+                begin(order) + i, begin(order) + j,
+                [&](Vertex l, Vertex r) {
+                    return std::make_pair(pts[l].Y(), l) <
+                           std::make_pair(pts[r].Y(), r);
+                });
+        }
+    }
+}
+
+namespace {
+
+struct CutPoint {
+    double x, y;
+    Vertex index;
+};
+
+// Reorders the x-sorted `cps[i, j)` so that the halves Recurse splits it
+// into at `depth` are separated by the seam of that depth, a horizontal
+// one at odd depths. A horizontal cut moves the lower half to the front
+// with a stable partition around the median y, so every range stays sorted
+// from left to right and vertical cuts need no work at all. `scratch` and
+// `ys` are as long as `cps`, a range only uses its own part of them.
+void CutAlternately(
+    std::vector<CutPoint> &cps, std::vector<CutPoint> &scratch,
+    std::vector<double> &ys, Index i, Index j, int depth,
+    WorkStealingPool *workers) {
+    if (j - i <= 3) {
+        return;
+    }
+    Index m = (i + j) / 2;
+    if (depth % 2 == 1) {
+        for (Index k = i; k < j; ++k) {
+            ys[k] = cps[k].y;
+        }
+        std::nth_element(begin(ys) + i, begin(ys) + m - 1, begin(ys) + j);
+        double cut = ys[m - 1];
+        Index lower = 0, level = 0;
+        for (Index k = i; k < j; ++k) {
+            lower += cps[k].y < cut;
+            level += cps[k].y == cut;
+        }
+        // of the points at the height of the cut, the ones further right
+        // go to the lower half
+        Index stay_up = level - (m - i - lower), kept_up = 0;
+        Index down = i, up = m;
+        for (Index k = i; k < j; ++k) {
+            const CutPoint &p = cps[k];
+            bool below = p.y < cut;
+            if (p.y == cut) {
+                below = kept_up == stay_up;
+                kept_up += not below;
+            }
+            scratch[below ? down++ : up++] = p;
+        }
+        assert(down == m and up == j);
+        std::copy(begin(scratch) + i, begin(scratch) + j, begin(cps) + i);
+    }
+    auto cut_left = [&] {
+        CutAlternately(cps, scratch, ys, i, m, depth + 1, workers);
+    };
+    auto cut_right = [&] {
+        CutAlternately(cps, scratch, ys, m, j, depth + 1, workers);
+    };
+    if (workers != nullptr and j - i >= kParallelCutoff) {
+        workers->Invoke(cut_left, cut_right);
+    } else {
+        cut_left();
+        cut_right();
+    }
+}
+
+// the vertex order the triangulation is built over, keeping only the
+// first of coinciding points, the one of least index, and the scratch space
+// that finds it
+struct Ordering {
+    std::vector<Vertex> order;
+    std::vector<RadixItem> items, buffer;
+    std::vector<CutPoint> cps, scratch;
+    std::vector<double> ys;
+
+    const std::vector<Vertex> &Of(
+        const std::vector<PointRef> &pts, DivideAndConquer::Cuts cuts,
+        WorkStealingPool *workers) {
+        SortFromLeftToRight(pts, workers, order, items, buffer);
+        // sorting put coinciding points next to each other
+        order.erase(
+            std::unique(
+                begin(order), end(order),
+                [&](Vertex l, Vertex r) {
+                    return pts[l].point == pts[r].point;
+                }),
+            end(order));
+        if (cuts == DivideAndConquer::Cuts::kAlternating) {
+            STATS_PHASE(kSort);
+            // the selections move the coordinates along instead of chasing
+            // them through `order`
+            cps.resize(order.size());
+            scratch.resize(order.size());
+            ys.resize(order.size());
+            for (size_t v = 0; v < order.size(); ++v) {
+                cps[v] = {pts[order[v]].X(), pts[order[v]].Y(), order[v]};
+            }
+            CutAlternately(cps, scratch, ys, 0, cps.size(), 0, workers);
+            for (size_t v = 0; v < order.size(); ++v) {
+                order[v] = cps[v].index;
+            }
+        }
+        return order;
+    }
 };
 
-void SortFromLeftToRight(std::vector<PointRef> &pts) {
-    std::sort(begin(pts), end(pts), [](const PointRef &l, const PointRef &r) {
-        return std::tie(l.point(0), l.point(1)) <
-               std::tie(r.point(0), r.point(1));
-    });
+// builds the triangulation of the points of `env` into its mesh, the
+// points being in the Order of `cuts`, and the top merge at `split` if any
+template <typename T>
+void Build(
+    Environment<T> &env, DivideAndConquer::Cuts cuts,
+    WorkStealingPool *workers, Index split = 0) {
+    // hulls hand their inner nodes back on every merge, so small blocks
+    // are enough and a pool never grows with the input
+    std::vector<typename ConvexHull<T>::NodePool> pools(
+        workers ? workers->Size() : 1);
+    DivideAndConquerImpl<T> driver(
+        env, pools, workers, env.Mesh().Whole(), cuts);
+    driver.Go(split);
+    for ([[maybe_unused]] const auto &pool : pools) {
+        LOGF(
+            "hull nodes: %lld allocated in %lld blocks", pool.Allocated(),
+            pool.Blocks());
+    }
 }
 
+// Triangulates `pts` over coordinates of type T and hands the environment
+// to `collect` for the result. The points are rounded to T before they are
+// ordered, so the order is the one of the coordinates the predicates see.
+template <typename T, typename F>
+auto Run(
+    Triangulator::InputPoints &pts, DivideAndConquer::Cuts cuts, int threads,
+    Index split, const F &collect) {
+    if constexpr (not std::is_same_v<T, double>) {
+        for (auto &p : pts) {
+            p.point = Point2D(
+                CoordinateTraits<T>::Round(p.X()),
+                CoordinateTraits<T>::Round(p.Y()));
+        }
+    }
+    auto workers = MakeWorkers(threads);
+    Environment<T> env;
+    {
+        Ordering ordering;
+        const auto &order = ordering.Of(pts, cuts, workers.get());
+        env.Assign(pts, order);
+        // what is left of the first `split` points still comes first
+        split = std::count_if(
+            begin(order), end(order), [split](Vertex v) { return v < split; });
+    }
+    // the environment keeps its own compact copy
+    Triangulator::InputPoints().swap(pts);
+    Build(env, cuts, workers.get(), split);
+    return collect(env);
+}
+
+// Run with the coordinate type of `coordinates`
+template <typename F>
+auto RunAs(
+    DivideAndConquer::Coordinates coordinates,
+    Triangulator::InputPoints &pts, DivideAndConquer::Cuts cuts, int threads,
+    const F &collect) {
+    switch (coordinates) {
+    case DivideAndConquer::Coordinates::kFloat:
+        return Run<float>(pts, cuts, threads, 0, collect);
+    case DivideAndConquer::Coordinates::kInt32:
+        // grid points too far out would overflow the exact predicates, such
+        // inputs are triangulated over doubles instead
+        if (std::all_of(begin(pts), end(pts), [](const PointRef &p) {
+                return CoordinateTraits<int32_t>::Fits(p.X()) and
+                       CoordinateTraits<int32_t>::Fits(p.Y());
+            })) {
+            return Run<int32_t>(pts, cuts, threads, 0, collect);
+        }
+        break;
+    case DivideAndConquer::Coordinates::kDouble:
+        break;
+    }
+    return Run<double>(pts, cuts, threads, 0, collect);
+}
+
+} // namespace
+
 Triangulator::OutputEdges
 DivideAndConquer::Triangulate(Triangulator::InputPoints pts) const {
-    SortFromLeftToRight(pts);
-    Environment env(pts);
-    DivideAndConquerImpl driver(env);
-    driver.Go();
-    return env.Edges();
+    return RunAs(
+        coordinates_, pts, cuts_, threads_,
+        [](auto &env) { return env.Edges(); });
+}
+
+Triangulator::OutputTriangles
+DivideAndConquer::TriangulateFaces(Triangulator::InputPoints pts) const {
+    return RunAs(
+        coordinates_, pts, cuts_, threads_,
+        [](auto &env) { return env.Triangles(); });
+}
+
+Index DivideAndConquer::MaxPoints() const {
+    return QuadEdgeMesh::kMaxVertices;
+}
+
+Triangulator::OutputTriangles DivideAndConquer::StitchFaces(
+    Triangulator::InputPoints left, Triangulator::InputPoints right) const {
+    Index split = left.size();
+    left.insert(end(left), begin(right), end(right));
+    Triangulator::InputPoints().swap(right);
+    // sorting keeps the points of `left` in front
+    return Run<double>(
+        left, Cuts::kVertical, threads_, split,
+        [](auto &env) { return env.Triangles(); });
+}
+
+struct TriangulationContext::Impl {
+    explicit Impl(DivideAndConquer::Cuts cuts)
+        : cuts(cuts), pools(1),
+          driver(env, pools, nullptr, env.Mesh().Whole(), cuts) {}
+
+    void Build(const Triangulator::InputPoints &pts) {
+        env.Assign(pts, ordering.Of(pts, cuts, nullptr));
+        driver.Go();
+    }
+
+    DivideAndConquer::Cuts cuts;
+    Environment<double> env;
+    Ordering ordering;
+    // the hulls hand every node back by the end of a run
+    std::vector<ConvexHull<double>::NodePool> pools;
+    DivideAndConquerImpl<double> driver;
+};
+
+TriangulationContext::TriangulationContext(DivideAndConquer::Cuts cuts)
+    : impl_(std::make_unique<Impl>(cuts)) {}
+
+TriangulationContext::~TriangulationContext() = default;
+
+TriangulationContext::TriangulationContext(TriangulationContext &&) noexcept =
+    default;
+
+TriangulationContext &
+TriangulationContext::operator=(TriangulationContext &&) noexcept = default;
+
+void TriangulationContext::Triangulate(
+    const Triangulator::InputPoints &points,
+    Triangulator::OutputEdges &edges) {
+    impl_->Build(points);
+    impl_->env.CollectEdges(edges);
+}
+
+void TriangulationContext::TriangulateFaces(
+    const Triangulator::InputPoints &points,
+    Triangulator::OutputTriangles &triangles) {
+    impl_->Build(points);
+    impl_->env.CollectTriangles(triangles);
+}
+
+BatchTriangulator::BatchTriangulator(int threads, DivideAndConquer::Cuts cuts)
+    : workers_(MakeWorkers(threads)) {
+    for (int i = 0; i < std::max(threads, 1); ++i) {
+        contexts_.emplace_back(cuts);
+    }
+}
+
+BatchTriangulator::~BatchTriangulator() = default;
+
+template <typename Result, typename F>
+void BatchTriangulator::ForEach(
+    const std::vector<Triangulator::InputPoints> &problems,
+    std::vector<Result> &results, const F &f) {
+    results.resize(problems.size());
+    auto run = [&](size_t i) {
+        int worker = workers_ ? workers_->WorkerIndex() : 0;
+        f(contexts_[worker], problems[i], results[i]);
+    };
+    ForEachIndex(workers_.get(), 0, problems.size(), kGrain, run);
+}
+
+void BatchTriangulator::Triangulate(
+    const std::vector<Triangulator::InputPoints> &problems,
+    std::vector<Triangulator::OutputEdges> &results) {
+    ForEach(
+        problems, results,
+        [](TriangulationContext &context,
+           const Triangulator::InputPoints &points,
+           Triangulator::OutputEdges &edges) {
+            context.Triangulate(points, edges);
+        });
+}
+
+void BatchTriangulator::TriangulateFaces(
+    const std::vector<Triangulator::InputPoints> &problems,
+    std::vector<Triangulator::OutputTriangles> &results) {
+    ForEach(
+        problems, results,
+        [](TriangulationContext &context,
+           const Triangulator::InputPoints &points,
+           Triangulator::OutputTriangles &triangles) {
+            context.TriangulateFaces(points, triangles);
+        });
 }
 
-} // namespace triangulation
\ No newline at end of file
+} // namespace triangulation
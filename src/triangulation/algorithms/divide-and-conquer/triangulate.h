@@ -3,10 +3,119 @@
 #include "triangulation/algorithms/interface.h"
 #include "triangulation/types.h"
 
+#include <memory>
+#include <vector>
+
 namespace triangulation {
 
+struct WorkStealingPool;
+
 struct DivideAndConquer : Triangulator {
+    // How the points are halved. Vertical cuts alone leave long and thin
+    // subproblems whose merges add many edges that later merges delete
+    // again. Alternating vertical and horizontal cuts level by level, as in
+    // Dwyer's variant, keeps them close to square on evenly spread points.
+    enum class Cuts { kVertical, kAlternating };
+
+    // What the points are kept and compared as. Float coordinates take half
+    // the memory of doubles, and widen to doubles exactly for the same
+    // filtered predicates. Int32 ones are grid points, compared with exact
+    // 64 and 128-bit integer arithmetic and no filter at all; they must lie
+    // within 2^29 of the origin, and inputs that do not are triangulated
+    // over doubles. Inputs are rounded to the nearest value of the type
+    // first, which can make distinct points coincide.
+    enum class Coordinates { kDouble, kFloat, kInt32 };
+
+    // `threads` > 1 triangulates the two halves of large subproblems in
+    // parallel
+    DivideAndConquer(
+        int threads = 1, Cuts cuts = Cuts::kVertical,
+        Coordinates coordinates = Coordinates::kDouble)
+        : threads_(threads), cuts_(cuts), coordinates_(coordinates) {}
+
     OutputEdges Triangulate(InputPoints points) const override;
+    OutputTriangles TriangulateFaces(InputPoints points) const override;
+
+    // the points are numbered 32-bit wide and so are the quad-edge mesh
+    // edges, of which each point takes 12
+    Index MaxPoints() const override;
+
+    // The triangles of `left` and `right` together, every point of `left`
+    // coming before every point of `right` from left to right: both sides
+    // are triangulated on their own with vertical cuts and stitched along
+    // the seam between their hulls, as one merge of the recursion. Always
+    // over double coordinates.
+    OutputTriangles StitchFaces(InputPoints left, InputPoints right) const;
+
+  private:
+    int threads_;
+    Cuts cuts_;
+    Coordinates coordinates_;
+};
+
+// Everything divide and conquer needs besides its input, the sorted copy
+// of the points, the mesh, the hull nodes and the scratch space, kept from
+// one run to the next. Triangulating many small point sets through one
+// context allocates only while it grows to the largest of them, where
+// DivideAndConquer sets all of it up anew every time. Runs on the calling
+// thread; a context must not be shared between threads.
+struct TriangulationContext {
+  public:
+    explicit TriangulationContext(
+        DivideAndConquer::Cuts cuts = DivideAndConquer::Cuts::kVertical);
+    ~TriangulationContext();
+
+    TriangulationContext(TriangulationContext &&) noexcept;
+    TriangulationContext &operator=(TriangulationContext &&) noexcept;
+
+    // the result replaces what `edges` or `triangles` held, reusing their
+    // capacity
+    void Triangulate(
+        const Triangulator::InputPoints &points,
+        Triangulator::OutputEdges &edges);
+    void TriangulateFaces(
+        const Triangulator::InputPoints &points,
+        Triangulator::OutputTriangles &triangles);
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Triangulates many independent point sets, each one whole on a single
+// worker of a pool of `threads`, every worker with a context of its own.
+// The pool and the contexts live as long as the batch triangulator, so
+// batch after batch reuses them.
+struct BatchTriangulator {
+  public:
+    explicit BatchTriangulator(
+        int threads = 1,
+        DivideAndConquer::Cuts cuts = DivideAndConquer::Cuts::kVertical);
+    ~BatchTriangulator();
+
+    BatchTriangulator(const BatchTriangulator &) = delete;
+    BatchTriangulator &operator=(const BatchTriangulator &) = delete;
+
+    // results[i] becomes the triangulation of problems[i], the vectors
+    // already in `results` are reused
+    void Triangulate(
+        const std::vector<Triangulator::InputPoints> &problems,
+        std::vector<Triangulator::OutputEdges> &results);
+    void TriangulateFaces(
+        const std::vector<Triangulator::InputPoints> &problems,
+        std::vector<Triangulator::OutputTriangles> &results);
+
+  private:
+    // point sets handed to a worker at a time
+    static constexpr size_t kGrain = 16;
+
+    template <typename Result, typename F>
+    void ForEach(
+        const std::vector<Triangulator::InputPoints> &problems,
+        std::vector<Result> &results, const F &f);
+
+    std::unique_ptr<WorkStealingPool> workers_;
+    std::vector<TriangulationContext> contexts_;
 };
 
-} // namespace triangulation
\ No newline at end of file
+} // namespace triangulation
@@ -0,0 +1,114 @@
+#include "triangulation/algorithms/incremental/dynamic.h"
+
+#include "triangulation/algorithms/collinear.h"
+#include "triangulation/algorithms/incremental/insertion-order.h"
+#include "triangulation/utility.h"
+
+#include <algorithm>
+
+namespace triangulation {
+
+Index DynamicTriangulation::Insert(const Point2D &p) {
+    Vertex v = NewVertex(p);
+    if (Meshed()) {
+        Vertex existing = mesh_.Insert(v);
+        if (existing != v) {
+            FreeVertex(v);
+        }
+        return existing;
+    }
+
+    for (Vertex u : flat_) {
+        if (pts_[u].point == p) {
+            FreeVertex(v);
+            return u;
+        }
+    }
+    flat_.push_back(v);
+    // the points before `v` are collinear, so the line through the first
+    // two of them decides whether `v` makes a triangle
+    if (flat_.size() >= 3 and ComputeOrientation(
+                                  pts_[flat_[0]].point, pts_[flat_[1]].point,
+                                  p) != kUnknown) {
+        mesh_.Init(flat_[0], flat_[1], v);
+        for (size_t i = 2; i + 1 < flat_.size(); ++i) {
+            mesh_.Insert(flat_[i]);
+        }
+        flat_.clear();
+    }
+    return v;
+}
+
+std::vector<Index>
+DynamicTriangulation::InsertMany(const std::vector<Point2D> &pts) {
+    std::vector<Index> result(pts.size());
+    for (uint32_t i : incremental::BrioOrder(TagPointWithIndex(pts))) {
+        result[i] = Insert(pts[i]);
+    }
+    return result;
+}
+
+bool DynamicTriangulation::Remove(Index id) {
+    if (not Contains(id)) {
+        return false;
+    }
+    if (not Meshed()) {
+        flat_.erase(std::find(begin(flat_), end(flat_), Vertex(id)));
+    } else {
+        mesh_.Remove(id);
+        if (not Meshed()) {
+            // only collinear points are left
+            mesh_.Clear();
+            for (Vertex v = 0; v < pts_.size(); ++v) {
+                if (live_[v] and v != id) {
+                    flat_.push_back(v);
+                }
+            }
+        }
+    }
+    FreeVertex(id);
+    return true;
+}
+
+std::vector<IdEdge> DynamicTriangulation::Edges() const {
+    if (Meshed()) {
+        return mesh_.Edges();
+    }
+    std::vector<PointRef> pts;
+    for (Vertex v : flat_) {
+        pts.push_back(pts_[v]);
+    }
+    return CollinearEdges(pts);
+}
+
+std::vector<IdTriangle> DynamicTriangulation::Triangles() const {
+    if (Meshed()) {
+        return mesh_.Triangles();
+    }
+    return {};
+}
+
+DynamicTriangulation::Vertex
+DynamicTriangulation::NewVertex(const Point2D &p) {
+    Vertex v;
+    if (not free_.empty()) {
+        v = free_.back();
+        free_.pop_back();
+    } else {
+        v = pts_.size();
+        pts_.emplace_back();
+        live_.push_back(0);
+    }
+    pts_[v] = PointRef{p, v};
+    live_[v] = 1;
+    ++size_;
+    return v;
+}
+
+void DynamicTriangulation::FreeVertex(Vertex v) {
+    live_[v] = 0;
+    free_.push_back(v);
+    --size_;
+}
+
+} // namespace triangulation
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "triangulation/algorithms/incremental/triangle-mesh.h"
+#include "triangulation/types.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+// A Delaunay triangulation kept up to date under point insertions and
+// removals. Every update only restructures the triangles around the point
+// it touches, so its cost depends on the size of the change and not on the
+// number of points.
+//
+// Points are known by the id Insert hands out. The id of a removed point is
+// given to a later insertion.
+struct DynamicTriangulation {
+  public:
+    DynamicTriangulation() : mesh_(pts_) {}
+
+    // the mesh refers to the points of this object
+    DynamicTriangulation(const DynamicTriangulation &) = delete;
+    DynamicTriangulation &operator=(const DynamicTriangulation &) = delete;
+
+    // returns the id of the new point, or of the point already at `p`
+    Index Insert(const Point2D &p);
+
+    // inserts the points in a spatially sorted order, which keeps the walks
+    // locating them short, returning their ids in the order given
+    std::vector<Index> InsertMany(const std::vector<Point2D> &pts);
+
+    // false if there is no point `id`
+    bool Remove(Index id);
+
+    bool Contains(Index id) const {
+        return id >= 0 and id < (Index)pts_.size() and live_[id];
+    }
+
+    const Point2D &Point(Index id) const {
+        return pts_[id].point;
+    }
+
+    // number of points in the triangulation
+    Index Size() const {
+        return size_;
+    }
+
+    std::vector<IdEdge> Edges() const;
+
+    // empty while all the points are collinear
+    std::vector<IdTriangle> Triangles() const;
+
+  private:
+    using Vertex = incremental::TriangleMesh::Vertex;
+
+    Vertex NewVertex(const Point2D &p);
+    void FreeVertex(Vertex v);
+
+    // while the points are all collinear there are no triangles, only the
+    // points in `flat_`
+    bool Meshed() const {
+        return mesh_.FiniteSize() > 0;
+    }
+
+    std::vector<PointRef> pts_;
+    std::vector<uint8_t> live_;
+    std::vector<Vertex> free_;
+    Index size_ = 0;
+    std::vector<Vertex> flat_;
+    incremental::TriangleMesh mesh_;
+};
+
+} // namespace triangulation
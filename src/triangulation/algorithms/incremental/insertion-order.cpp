@@ -0,0 +1,74 @@
+#include "triangulation/algorithms/incremental/insertion-order.h"
+
+#include "triangulation/hilbert-curve.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace triangulation {
+
+namespace incremental {
+
+namespace {
+
+constexpr int kHilbertOrder = 16;
+constexpr size_t kMinRoundSize = 64;
+
+} // namespace
+
+std::vector<uint32_t>
+BrioOrder(const std::vector<PointRef> &pts, uint32_t seed) {
+    std::vector<uint32_t> order(pts.size());
+    for (size_t i = 0; i < pts.size(); ++i) {
+        order[i] = i;
+    }
+    if (pts.empty()) {
+        return order;
+    }
+    std::mt19937 gen(seed);
+    std::shuffle(begin(order), end(order), gen);
+
+    double min_x = pts[0].X(), max_x = min_x, min_y = pts[0].Y(),
+           max_y = min_y;
+    for (const auto &p : pts) {
+        min_x = std::min(min_x, p.X());
+        max_x = std::max(max_x, p.X());
+        min_y = std::min(min_y, p.Y());
+        max_y = std::max(max_y, p.Y());
+    }
+    double cells = (1u << kHilbertOrder) - 1;
+    double scale_x = max_x > min_x ? cells / (max_x - min_x) : 0;
+    double scale_y = max_y > min_y ? cells / (max_y - min_y) : 0;
+
+    std::vector<std::pair<uint64_t, uint32_t>> keyed;
+    auto sort_round = [&](size_t begin, size_t end) {
+        keyed.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const auto &p = pts[order[i]];
+            keyed.emplace_back(
+                HilbertIndex(
+                    (p.X() - min_x) * scale_x, (p.Y() - min_y) * scale_y,
+                    kHilbertOrder),
+                order[i]);
+        }
+        std::sort(keyed.begin(), keyed.end());
+        for (size_t i = begin; i < end; ++i) {
+            order[i] = keyed[i - begin].second;
+        }
+    };
+
+    // the last round holds half of the points, the one before a quarter...
+    size_t end = pts.size();
+    while (end > kMinRoundSize) {
+        size_t begin = end / 2;
+        sort_round(begin, end);
+        end = begin;
+    }
+    sort_round(0, end);
+    return order;
+}
+
+} // namespace incremental
+
+} // namespace triangulation
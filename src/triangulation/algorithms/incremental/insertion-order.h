@@ -0,0 +1,21 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+namespace incremental {
+
+// Biased randomized insertion order: the points are shuffled and cut into
+// rounds doubling in size, each round sorted along a Hilbert curve. The
+// randomness keeps the expected amount of restructuring low, the curve keeps
+// consecutive points close so locating them takes a short walk.
+std::vector<uint32_t>
+BrioOrder(const std::vector<PointRef> &pts, uint32_t seed = 0);
+
+} // namespace incremental
+
+} // namespace triangulation
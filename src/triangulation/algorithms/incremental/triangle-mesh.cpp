@@ -0,0 +1,349 @@
+#include "triangulation/algorithms/incremental/triangle-mesh.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace triangulation {
+
+namespace incremental {
+
+void TriangleMesh::Init(Vertex a, Vertex b, Vertex c) {
+    Orientation o = ComputeOrientation(PointOf(a), PointOf(b), PointOf(c));
+    assert(o != kUnknown);
+    if (o == kClockwise) {
+        std::swap(b, c);
+    }
+    Triangle t = NewTriangle(a, b, c);
+    Triangle ab = NewTriangle(b, a, kInfinite);
+    Triangle bc = NewTriangle(c, b, kInfinite);
+    Triangle ca = NewTriangle(a, c, kInfinite);
+    SetNeighbor(t, 0, bc);
+    SetNeighbor(t, 1, ca);
+    SetNeighbor(t, 2, ab);
+    // the ghost triangles form a ring around the hull
+    for (auto [g, next, prev] : {std::tuple{ab, ca, bc}, std::tuple{bc, ab, ca},
+                                 std::tuple{ca, bc, ab}}) {
+        SetNeighbor(g, 0, next);
+        SetNeighbor(g, 1, prev);
+        SetNeighbor(g, 2, t);
+    }
+    last_ = t;
+}
+
+TriangleMesh::Vertex TriangleMesh::Insert(Vertex v) {
+    const Point2D &p = PointOf(v);
+    Triangle t = Locate(p, last_);
+    if (not IsGhost(t)) {
+        for (int k = 0; k < 3; ++k) {
+            if (PointOf(Corner(t, k)) == p) {
+                return Corner(t, k);
+            }
+        }
+    }
+
+    // grow the cavity from `t` over every triangle in conflict with `p`, it
+    // is star-shaped around `p` and connected
+    cavity_.clear();
+    hole_.clear();
+    Kill(t);
+    cavity_.push_back(t);
+    for (size_t i = 0; i < cavity_.size(); ++i) {
+        Triangle c = cavity_[i];
+        for (int k = 0; k < 3; ++k) {
+            Triangle n = Neighbor(c, k);
+            if (dead_[n]) {
+                continue;
+            }
+            if (InConflict(n, p)) {
+                Kill(n);
+                cavity_.push_back(n);
+            } else {
+                hole_.push_back(HoleEdge{
+                    Corner(c, (k + 1) % 3), Corner(c, (k + 2) % 3), n,
+                    IndexOf(n, c)});
+            }
+        }
+    }
+
+    // fill the hole with a fan of triangles around `p`
+    if (fan_from_.size() < pts_.size()) {
+        fan_from_.resize(pts_.size(), kNoTriangle);
+    }
+    fan_.clear();
+    for (const auto &e : hole_) {
+        Triangle f = NewTriangle(e.from, e.to, v);
+        SetNeighbor(f, 2, e.outside);
+        SetNeighbor(e.outside, e.outside_corner, f);
+        FanFrom(e.from) = f;
+        fan_.push_back(f);
+    }
+    for (Triangle f : fan_) {
+        Triangle next = FanFrom(Corner(f, 1));
+        SetNeighbor(f, 0, next);
+        SetNeighbor(next, 1, f);
+        if (not IsGhost(f)) {
+            last_ = f;
+        }
+    }
+    return v;
+}
+
+void TriangleMesh::Relabel(Vertex from, Vertex to) {
+    Triangle start = VertexTriangle(from);
+    assert(start != kNoTriangle and PointOf(from) == PointOf(to));
+    Triangle t = start;
+    do {
+        int k = CornerOf(t, from);
+        corners_[t * 3 + k] = to;
+        t = Neighbor(t, (k + 1) % 3);
+    } while (t != start);
+    vertex_triangle_[to] = start;
+    vertex_triangle_[from] = kNoTriangle;
+}
+
+void TriangleMesh::Remove(Vertex v) {
+    Triangle start = VertexTriangle(v);
+    assert(start != kNoTriangle);
+
+    // the hole polygon, counter-clockwise around `v`
+    cavity_.clear();
+    hole_.clear();
+    Triangle t = start;
+    do {
+        int k = CornerOf(t, v);
+        Triangle outside = Neighbor(t, k);
+        hole_.push_back(HoleEdge{
+            Corner(t, (k + 1) % 3), Corner(t, (k + 2) % 3), outside,
+            IndexOf(outside, t)});
+        cavity_.push_back(t);
+        t = Neighbor(t, (k + 1) % 3);
+    } while (t != start);
+    for (Triangle c : cavity_) {
+        Kill(c);
+    }
+    vertex_triangle_[v] = kNoTriangle;
+
+    fan_.clear();
+    size_t i = 0;
+    // the candidates tried since the last ear, a whole round at most
+    size_t tries [[maybe_unused]] = 0;
+    while (hole_.size() > 3) {
+        if (not IsEar(i)) {
+            i = (i + 1) % hole_.size();
+            ++tries;
+            assert(tries <= hole_.size());
+            continue;
+        }
+        size_t j = (i + 1) % hole_.size();
+        HoleEdge a = hole_[i], b = hole_[j];
+        Triangle ear = NewTriangle(a.from, b.from, b.to);
+        Glue(ear, 2, a);
+        Glue(ear, 0, b);
+        fan_.push_back(ear);
+        hole_[i] = HoleEdge{a.from, b.to, ear, 1};
+        hole_.erase(hole_.begin() + j);
+        if (j < i) {
+            --i;
+        }
+        tries = 0;
+    }
+    Triangle rest = NewTriangle(hole_[0].from, hole_[1].from, hole_[2].from);
+    Glue(rest, 2, hole_[0]);
+    Glue(rest, 0, hole_[1]);
+    Glue(rest, 1, hole_[2]);
+    fan_.push_back(rest);
+
+    // keep the walks starting from a finite triangle
+    last_ = kNoTriangle;
+    for (Triangle f : fan_) {
+        if (not IsGhost(f)) {
+            last_ = f;
+        } else if (last_ == kNoTriangle) {
+            Triangle across = Neighbor(f, CornerOf(f, kInfinite));
+            if (not IsGhost(across)) {
+                last_ = across;
+            }
+        }
+    }
+    assert(last_ != kNoTriangle or finite_ == 0);
+}
+
+void TriangleMesh::Clear() {
+    corners_.clear();
+    neighbors_.clear();
+    dead_.clear();
+    free_.clear();
+    vertex_triangle_.clear();
+    finite_ = 0;
+    last_ = kNoTriangle;
+}
+
+TriangleMesh::Triangle TriangleMesh::Locate(const Point2D &p, Triangle t) {
+    assert(Alive(t) and not IsGhost(t));
+    for (;;) {
+        // starting from a random edge keeps the walk from cycling
+        int k = NextRandom() % 3;
+        Triangle next = kNoTriangle;
+        for (int i = 0; i < 3; ++i, k = (k + 1) % 3) {
+            const Point2D &a = PointOf(Corner(t, (k + 1) % 3)),
+                          &b = PointOf(Corner(t, (k + 2) % 3));
+            if (ComputeOrientation(a, b, p) == kClockwise) {
+                next = Neighbor(t, k);
+                break;
+            }
+        }
+        if (next == kNoTriangle or IsGhost(next)) {
+            return next == kNoTriangle ? t : next;
+        }
+        t = next;
+    }
+}
+
+std::vector<IdEdge> TriangleMesh::Edges() const {
+    std::vector<IdEdge> result;
+    for (Triangle t = 0; t < TriangleSize(); ++t) {
+        if (not Alive(t) or IsGhost(t)) {
+            continue;
+        }
+        for (int k = 0; k < 3; ++k) {
+            Triangle n = Neighbor(t, k);
+            if (n < t and not IsGhost(n)) {
+                continue;
+            }
+            Index i = pts_[Corner(t, (k + 1) % 3)].id,
+                  j = pts_[Corner(t, (k + 2) % 3)].id;
+            result.push_back(i < j ? IdEdge{i, j} : IdEdge{j, i});
+        }
+    }
+    return result;
+}
+
+std::vector<IdTriangle> TriangleMesh::Triangles() const {
+    std::vector<Index> number(TriangleSize(), kNoNeighbor);
+    Index count = 0;
+    for (Triangle t = 0; t < TriangleSize(); ++t) {
+        if (Alive(t) and not IsGhost(t)) {
+            number[t] = count++;
+        }
+    }
+    std::vector<IdTriangle> result;
+    result.reserve(count);
+    for (Triangle t = 0; t < TriangleSize(); ++t) {
+        if (number[t] == kNoNeighbor) {
+            continue;
+        }
+        IdTriangle tri;
+        for (int k = 0; k < 3; ++k) {
+            tri.vertices[k] = pts_[Corner(t, k)].id;
+            // ghosts are numbered kNoNeighbor
+            tri.neighbors[k] = number[Neighbor(t, k)];
+        }
+        result.push_back(tri);
+    }
+    return result;
+}
+
+bool TriangleMesh::InConflict(
+    Vertex a, Vertex b, Vertex c, const Point2D &p) const {
+    // the finite edge of a ghost triangle, in counter-clockwise order
+    if (a == kInfinite) {
+        a = b;
+        b = c;
+    } else if (b == kInfinite) {
+        b = a;
+        a = c;
+    } else if (c != kInfinite) {
+        return InCircle(PointOf(a), PointOf(b), PointOf(c), p);
+    }
+    const Point2D &u = PointOf(a), &w = PointOf(b);
+    Orientation o = ComputeOrientation(u, w, p);
+    if (o != kUnknown) {
+        return o == kCounterClockwise;
+    }
+    // collinear, compare along the coordinate the edge is not
+    // perpendicular to, which is exact
+    int axis = u(0) != w(0) ? 0 : 1;
+    return std::min(u(axis), w(axis)) < p(axis) and
+           p(axis) < std::max(u(axis), w(axis));
+}
+
+bool TriangleMesh::IsEar(size_t i) const {
+    size_t m = hole_.size();
+    const HoleEdge &first = hole_[i], &second = hole_[(i + 1) % m];
+    Vertex a = first.from, b = second.from, c = second.to;
+    if (a != kInfinite and b != kInfinite and c != kInfinite and
+        ComputeOrientation(PointOf(a), PointOf(b), PointOf(c)) !=
+            kCounterClockwise) {
+        return false;
+    }
+    for (const auto &e : hole_) {
+        Vertex d = e.from;
+        if (d != a and d != b and d != c and d != kInfinite and
+            InConflict(a, b, c, PointOf(d))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TriangleMesh::Triangle
+TriangleMesh::NewTriangle(Vertex a, Vertex b, Vertex c) {
+    Triangle t;
+    if (not free_.empty()) {
+        t = free_.back();
+        free_.pop_back();
+        dead_[t] = 0;
+    } else {
+        t = dead_.size();
+        dead_.push_back(0);
+        neighbors_.insert(neighbors_.end(), 3, kNoTriangle);
+        corners_.insert(corners_.end(), 3, kInfinite);
+    }
+    corners_[t * 3] = a;
+    corners_[t * 3 + 1] = b;
+    corners_[t * 3 + 2] = c;
+    if (vertex_triangle_.size() < pts_.size()) {
+        vertex_triangle_.resize(pts_.size(), kNoTriangle);
+    }
+    for (Vertex v : {a, b, c}) {
+        if (v != kInfinite) {
+            vertex_triangle_[v] = t;
+        }
+    }
+    if (not IsGhost(t)) {
+        ++finite_;
+    }
+    return t;
+}
+
+void TriangleMesh::Kill(Triangle t) {
+    if (not IsGhost(t)) {
+        --finite_;
+    }
+    dead_[t] = 1;
+    free_.push_back(t);
+}
+
+int TriangleMesh::IndexOf(Triangle t, Triangle n) const {
+    for (int k = 0; k < 3; ++k) {
+        if (Neighbor(t, k) == n) {
+            return k;
+        }
+    }
+    assert(false);
+    return -1;
+}
+
+int TriangleMesh::CornerOf(Triangle t, Vertex v) const {
+    for (int k = 0; k < 3; ++k) {
+        if (Corner(t, k) == v) {
+            return k;
+        }
+    }
+    assert(false);
+    return -1;
+}
+
+} // namespace incremental
+
+} // namespace triangulation
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "triangulation/types.h"
+#include "triangulation/utility.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+namespace incremental {
+
+// Delaunay triangulation stored as counter-clockwise triangles, each knowing
+// the triangle across the edge opposite to every one of its corners.
+//
+// Every hull edge is closed off by a ghost triangle whose third corner is
+// the vertex at infinity, so every triangle has three neighbors and points
+// outside the hull are inserted the same way as the ones inside.
+struct TriangleMesh {
+    using Vertex = uint32_t;
+    using Triangle = uint32_t;
+    static constexpr Vertex kInfinite = ~Vertex(0);
+    static constexpr Triangle kNoTriangle = ~Triangle(0);
+
+    // vertices are indices into `pts`, which must outlive the mesh
+    TriangleMesh(const std::vector<PointRef> &pts) : pts_(pts) {}
+
+    // starts from the triangle a, b, c, which must not be collinear
+    void Init(Vertex a, Vertex b, Vertex c);
+
+    // Bowyer-Watson insertion: the triangles whose circumcircle contains
+    // the point are removed and the hole is filled with a fan around it.
+    // Returns `v`, or the vertex of the mesh it coincides with, leaving the
+    // mesh untouched.
+    Vertex Insert(Vertex v);
+
+    // puts `to`, a point coinciding with the vertex `from`, in its place
+    void Relabel(Vertex from, Vertex to);
+
+    // Takes `v` out and fills the hole left by its triangles with Delaunay
+    // ears of the surrounding polygon: each ear is the triangle a flip of
+    // one of v's edges would produce, clipped only if no other vertex of
+    // the polygon lies inside its circumcircle. If every finite triangle
+    // goes with it, the remaining vertices are collinear and FiniteSize()
+    // drops to 0.
+    void Remove(Vertex v);
+
+    // forgets every triangle
+    void Clear();
+
+    // the triangle containing `p`, or the ghost triangle of a hull edge
+    // seeing `p`, found by walking from `start` towards `p`
+    Triangle Locate(const Point2D &p, Triangle start);
+
+    Triangle LastTriangle() const {
+        return last_;
+    }
+
+    // a triangle having `v` as a corner, kNoTriangle if `v` is not in the
+    // mesh
+    Triangle VertexTriangle(Vertex v) const {
+        return v < vertex_triangle_.size() ? vertex_triangle_[v] : kNoTriangle;
+    }
+
+    Vertex Corner(Triangle t, int k) const {
+        return corners_[t * 3 + k];
+    }
+    Triangle Neighbor(Triangle t, int k) const {
+        return neighbors_[t * 3 + k];
+    }
+    bool IsGhost(Triangle t) const {
+        return Corner(t, 0) == kInfinite or Corner(t, 1) == kInfinite or
+               Corner(t, 2) == kInfinite;
+    }
+    bool Alive(Triangle t) const {
+        return not dead_[t];
+    }
+
+    // number of triangle slots, including the dead ones
+    Triangle TriangleSize() const {
+        return dead_.size();
+    }
+
+    // number of live triangles not touching the vertex at infinity
+    Triangle FiniteSize() const {
+        return finite_;
+    }
+
+    std::vector<IdEdge> Edges() const;
+
+    // the finite triangles, numbered in storage order
+    std::vector<IdTriangle> Triangles() const;
+
+  private:
+    const Point2D &PointOf(Vertex v) const {
+        return pts_[v].point;
+    }
+
+    // whether `p` lies strictly inside the circumcircle of the
+    // counter-clockwise a, b, c; for a ghost triangle that is the open half
+    // plane beyond its hull edge plus the open hull edge itself
+    bool InConflict(Vertex a, Vertex b, Vertex c, const Point2D &p) const;
+    bool InConflict(Triangle t, const Point2D &p) const {
+        return InConflict(Corner(t, 0), Corner(t, 1), Corner(t, 2), p);
+    }
+
+    Triangle NewTriangle(Vertex a, Vertex b, Vertex c);
+    void Kill(Triangle t);
+    void SetNeighbor(Triangle t, int k, Triangle n) {
+        neighbors_[t * 3 + k] = n;
+    }
+    // the corner of `t` opposite to its shared edge with `n`
+    int IndexOf(Triangle t, Triangle n) const;
+    int CornerOf(Triangle t, Vertex v) const;
+
+    // whether the triangle on the three consecutive corners of the hole
+    // polygon starting at `i` is a Delaunay ear
+    bool IsEar(size_t i) const;
+
+    uint32_t NextRandom() {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 17;
+        random_ ^= random_ << 5;
+        return random_;
+    }
+
+    // an edge of the hole left by the removed triangles, `outside` is the
+    // surviving triangle across it
+    struct HoleEdge {
+        Vertex from, to;
+        Triangle outside;
+        int outside_corner;
+    };
+
+    void Glue(Triangle t, int k, const HoleEdge &e) {
+        SetNeighbor(t, k, e.outside);
+        SetNeighbor(e.outside, e.outside_corner, t);
+    }
+
+    const std::vector<PointRef> &pts_;
+    std::vector<Vertex> corners_;
+    std::vector<Triangle> neighbors_;
+    std::vector<uint8_t> dead_;
+    std::vector<Triangle> free_;
+    std::vector<Triangle> vertex_triangle_;
+    Triangle finite_ = 0;
+    Triangle last_ = kNoTriangle;
+    uint32_t random_ = 2463534242u;
+
+    // scratch space of Insert
+    std::vector<Triangle> cavity_;
+    std::vector<HoleEdge> hole_;
+    std::vector<Triangle> fan_;
+    std::vector<Triangle> fan_from_;
+    Triangle fan_from_infinite_ = kNoTriangle;
+
+    // the new triangle whose edge on the hole starts at `v`
+    Triangle &FanFrom(Vertex v) {
+        return v == kInfinite ? fan_from_infinite_ : fan_from_[v];
+    }
+};
+
+} // namespace incremental
+
+} // namespace triangulation
@@ -0,0 +1,72 @@
+#include "triangulation/algorithms/incremental/triangulate.h"
+
+#include "triangulation/algorithms/collinear.h"
+#include "triangulation/algorithms/incremental/insertion-order.h"
+#include "triangulation/algorithms/incremental/triangle-mesh.h"
+#include "triangulation/utility.h"
+
+namespace triangulation {
+
+using namespace incremental;
+
+namespace {
+
+// false if all the points are collinear, `mesh` is left empty then
+bool Build(
+    TriangleMesh &mesh, const std::vector<PointRef> &pts, uint32_t seed) {
+    auto order = BrioOrder(pts, seed);
+
+    // the first triangle is the first point, the first one apart from it and
+    // the first one off the line through both
+    size_t second = 1;
+    while (second < order.size() and
+           pts[order[second]].point == pts[order[0]].point) {
+        ++second;
+    }
+    size_t third = second + 1;
+    while (third < order.size() and
+           ComputeOrientation(
+               pts[order[0]].point, pts[order[second]].point,
+               pts[order[third]].point) == kUnknown) {
+        ++third;
+    }
+    if (third >= order.size()) {
+        return false;
+    }
+
+    mesh.Init(order[0], order[second], order[third]);
+    for (size_t i = 1; i < order.size(); ++i) {
+        if (i == second or i == third) {
+            continue;
+        }
+        // of coinciding points the first one in `pts` stays, as in the
+        // other triangulators
+        TriangleMesh::Vertex v = mesh.Insert(order[i]);
+        if (order[i] < v) {
+            mesh.Relabel(v, order[i]);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+Triangulator::OutputEdges
+Incremental::Triangulate(Triangulator::InputPoints pts) const {
+    TriangleMesh mesh(pts);
+    if (not Build(mesh, pts, seed_)) {
+        return CollinearEdges(pts);
+    }
+    return mesh.Edges();
+}
+
+Triangulator::OutputTriangles
+Incremental::TriangulateFaces(Triangulator::InputPoints pts) const {
+    TriangleMesh mesh(pts);
+    if (not Build(mesh, pts, seed_)) {
+        return {};
+    }
+    return mesh.Triangles();
+}
+
+} // namespace triangulation
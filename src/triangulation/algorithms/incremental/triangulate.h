@@ -0,0 +1,24 @@
+#pragma once
+
+#include "triangulation/algorithms/interface.h"
+#include "triangulation/types.h"
+
+#include <stdint.h>
+
+namespace triangulation {
+
+// Randomized incremental construction: points are inserted one at a time in
+// a spatially sorted random order, each located by walking from the
+// previous one and inserted with Bowyer-Watson.
+struct Incremental : Triangulator {
+    // `seed` drives the random part of the insertion order
+    Incremental(uint32_t seed = 0) : seed_(seed) {}
+
+    OutputEdges Triangulate(InputPoints points) const override;
+    OutputTriangles TriangulateFaces(InputPoints points) const override;
+
+  private:
+    uint32_t seed_;
+};
+
+} // namespace triangulation
@@ -2,14 +2,27 @@
 
 #include "triangulation/types.h"
 
+#include <limits>
+
 namespace triangulation {
 
 struct Triangulator {
     using InputPoints = std::vector<PointRef>;
     using OutputEdges = std::vector<IdEdge>;
+    using OutputTriangles = std::vector<IdTriangle>;
 
     virtual OutputEdges Triangulate(InputPoints points) const = 0;
 
+    // the same triangulation as its triangles, read straight off the
+    // internal topology; empty when all the points are collinear
+    virtual OutputTriangles TriangulateFaces(InputPoints points) const = 0;
+
+    // the most points one run takes, larger inputs are for the caller to
+    // turn down
+    virtual Index MaxPoints() const {
+        return std::numeric_limits<Index>::max();
+    }
+
     virtual ~Triangulator() = default;
 };
 
@@ -0,0 +1,400 @@
+#include "triangulation/algorithms/out-of-core/triangulate.h"
+
+#include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/io/point-set.h"
+#include "triangulation/io/text-output.h"
+
+#include <algorithm>
+#include <cmath>
+#include <errno.h>
+#include <limits>
+#include <memory>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace triangulation {
+
+namespace {
+
+// points read from the input at a time
+constexpr size_t kBlockPoints = 1 << 16;
+
+// the strip boundaries are quantiles of about this many sampled x
+constexpr Index kSamplePoints = 1 << 16;
+
+// write buffer of every strip file
+constexpr size_t kStripBuffer = 1 << 16;
+
+// a point as stored in a strip file
+struct StripRecord {
+    double x, y;
+    Index id;
+};
+
+struct FileCloser {
+    void operator()(FILE *f) const {
+        fclose(f);
+    }
+};
+
+using FilePtr = std::unique_ptr<FILE, FileCloser>;
+
+// a temporary file in `dir` that is gone once closed
+FilePtr TempFile(const std::string &dir, std::string &error) {
+    std::string path = dir + "/triangulation-strip-XXXXXX";
+    int fd = mkstemp(path.data());
+    if (fd == -1) {
+        error = "cannot create a file in " + dir + ": " + strerror(errno);
+        return nullptr;
+    }
+    unlink(path.c_str());
+    FILE *f = fdopen(fd, "w+b");
+    if (f == nullptr) {
+        error = "cannot open a file in " + dir + ": " + strerror(errno);
+        close(fd);
+    }
+    return FilePtr(f);
+}
+
+// Whether the circle through the counter-clockwise a, b, c lies strictly
+// left of the line x = `limit`. It is answered in floating point with a
+// margin well over the rounding error, and flat triangles are turned down
+// outright, so a wrong answer is always a no, which only keeps a triangle
+// around for longer.
+bool CircleLeftOf(
+    const Point2D &a, const Point2D &b, const Point2D &c, double limit) {
+    double bx = b(0) - a(0), by = b(1) - a(1);
+    double cx = c(0) - a(0), cy = c(1) - a(1);
+    double det = bx * cy - by * cx;
+    if (det <= 1e-4 * (std::abs(bx * cy) + std::abs(by * cx))) {
+        return false;
+    }
+    double b_lift = bx * bx + by * by, c_lift = cx * cx + cy * cy;
+    double ux = (cy * b_lift - by * c_lift) / (2 * det);
+    double uy = (bx * c_lift - cx * b_lift) / (2 * det);
+    double right = a(0) + ux + std::sqrt(ux * ux + uy * uy);
+    double scale = std::abs(a(0)) + std::abs(limit) +
+                   (std::abs(cy * b_lift) + std::abs(by * c_lift) +
+                    std::abs(bx * c_lift) + std::abs(cx * b_lift)) /
+                       det;
+    return right < limit - 1e-9 * scale;
+}
+
+uint64_t Key(uint32_t u, uint32_t v) {
+    return uint64_t(u) << 32 | v;
+}
+
+// The sweep over the strips. Between two strips it keeps the points still
+// needed and the frontier: the directed edges with a final triangle on
+// their left, gone from memory, and on their right either a triangle not
+// final yet or nothing so far. Triangulating the kept points again fills
+// the final part with triangles of its own, which the frontier fences in.
+struct StripSweep {
+  public:
+    using Local = uint32_t;
+
+    explicit StripSweep(int threads) : engine_(threads) {}
+
+    Index ActiveSize() const {
+        return active_.size();
+    }
+
+    // joins `strip`, whose points come after every point so far, and
+    // returns the triangles that became final; `limit` is the least x of
+    // the points still to come, and everything is final after the last
+    // strip
+    std::vector<IdTriangle>
+    Add(const std::vector<PointRef> &strip, double limit, bool last) {
+        size_t kept = active_.size(), size = kept + strip.size();
+        // the kept points come first, local vertex i is points_[i]
+        points_.resize(kept);
+        ids_.resize(kept);
+        for (const auto &p : strip) {
+            points_.push_back(p.point);
+            ids_.push_back(p.id);
+        }
+        Triangulator::InputPoints left(kept), right(strip.size());
+        for (size_t i = 0; i < size; ++i) {
+            (i < kept ? left[i] : right[i - kept]) = {points_[i], Index(i)};
+        }
+        auto tris = engine_.StitchFaces(std::move(left), std::move(right));
+
+        std::unordered_set<uint64_t> frontier;
+        for (auto [u, v] : frontier_) {
+            frontier.insert(Key(u, v));
+        }
+        // the edge opposite vertex k of `t`, with `t` on its left
+        auto edge = [&tris](size_t t, int k) {
+            const auto &v = tris[t].vertices;
+            return std::make_pair(Local(v[(k + 1) % 3]), Local(v[(k + 2) % 3]));
+        };
+
+        // the triangles on the final side of the frontier were written
+        // out before, the ones here only fill the gap
+        state_.assign(tris.size(), kPending);
+        std::vector<size_t> stack;
+        for (size_t t = 0; t < tris.size(); ++t) {
+            for (int k = 0; k < 3; ++k) {
+                auto [p, q] = edge(t, k);
+                if (state_[t] != kFiller and frontier.count(Key(p, q))) {
+                    state_[t] = kFiller;
+                    stack.push_back(t);
+                }
+            }
+        }
+        while (not stack.empty()) {
+            size_t t = stack.back();
+            stack.pop_back();
+            for (int k = 0; k < 3; ++k) {
+                Index n = tris[t].neighbors[k];
+                auto [p, q] = edge(t, k);
+                if (n == kNoNeighbor or state_[n] == kFiller or
+                    frontier.count(Key(p, q))) {
+                    continue;
+                }
+                state_[n] = kFiller;
+                stack.push_back(n);
+            }
+        }
+
+        std::vector<IdTriangle> result;
+        for (size_t t = 0; t < tris.size(); ++t) {
+            const auto &v = tris[t].vertices;
+            if (state_[t] == kPending and
+                (last or CircleLeftOf(
+                             points_[v[0]], points_[v[1]], points_[v[2]],
+                             limit))) {
+                state_[t] = kFinal;
+                result.push_back(
+                    {{ids_[v[0]], ids_[v[1]], ids_[v[2]]},
+                     {kNoNeighbor, kNoNeighbor, kNoNeighbor}});
+            }
+        }
+
+        // an edge joins the frontier when one side just became final and
+        // the other is not, and leaves it when the pending side does
+        std::vector<std::pair<Local, Local>> next;
+        std::unordered_set<uint64_t> crossed;
+        for (size_t t = 0; t < tris.size(); ++t) {
+            if (state_[t] == kFiller) {
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                auto [p, q] = edge(t, k);
+                Index n = tris[t].neighbors[k];
+                bool was_frontier = frontier.count(Key(q, p));
+                if (was_frontier) {
+                    crossed.insert(Key(q, p));
+                }
+                bool done = state_[t] == kFinal;
+                bool other_done =
+                    n == kNoNeighbor ? was_frontier : state_[n] != kPending;
+                if (done and not other_done) {
+                    next.emplace_back(p, q);
+                } else if (not done and other_done) {
+                    next.emplace_back(q, p);
+                }
+            }
+        }
+        // the ones with still nothing on their right
+        for (auto [u, v] : frontier_) {
+            if (not crossed.count(Key(u, v))) {
+                next.emplace_back(u, v);
+            }
+        }
+
+        // points of pending triangles and of the frontier are kept, and
+        // so are those in no triangle at all, as on a line
+        std::vector<uint8_t> in_triangle(size), keep(size);
+        for (size_t t = 0; t < tris.size(); ++t) {
+            for (Index v : tris[t].vertices) {
+                in_triangle[v] = true;
+                keep[v] |= state_[t] == kPending;
+            }
+        }
+        for (auto [u, v] : next) {
+            keep[u] = keep[v] = true;
+        }
+        std::vector<Local> position(size);
+        active_.clear();
+        for (size_t i = 0; i < size; ++i) {
+            if (keep[i] or not in_triangle[i]) {
+                position[i] = active_.size();
+                active_.push_back({points_[i], ids_[i]});
+            }
+        }
+        frontier_.clear();
+        for (auto [u, v] : next) {
+            frontier_.emplace_back(position[u], position[v]);
+        }
+        for (size_t i = 0; i < active_.size(); ++i) {
+            points_[i] = active_[i].point;
+            ids_[i] = active_[i].id;
+        }
+        return result;
+    }
+
+  private:
+    enum State : uint8_t { kPending, kFinal, kFiller };
+
+    DivideAndConquer engine_;
+    std::vector<PointRef> active_;
+    std::vector<std::pair<Local, Local>> frontier_;
+
+    // scratch space of Add
+    std::vector<Point2D> points_;
+    std::vector<Index> ids_;
+    std::vector<State> state_;
+};
+
+} // namespace
+
+bool TriangulateOutOfCore(
+    const char *path, FILE *out, const OutOfCoreOptions &options,
+    OutOfCoreStats &stats, std::string &error) {
+    BinaryPointReader reader;
+    if (not reader.Open(path, error)) {
+        return false;
+    }
+    Index n = reader.Size();
+    stats = OutOfCoreStats{};
+    stats.points = n;
+    auto read_error = [&] {
+        error = std::string("cannot read ") + path;
+        return false;
+    };
+    auto write_error = [&] {
+        error = "cannot write the result";
+        return false;
+    };
+
+    // first pass: the points go out as they are, and every stride-th x is
+    // sampled for the strip boundaries
+    if (out != nullptr and not WritePointCountText(n, out)) {
+        return write_error();
+    }
+    Index stride = std::max<Index>(1, n / kSamplePoints);
+    std::vector<double> sample;
+    std::vector<Point2D> block;
+    for (Index first = 0;; first += block.size()) {
+        if (not reader.Read(block, kBlockPoints)) {
+            return read_error();
+        }
+        if (block.empty()) {
+            break;
+        }
+        if (out != nullptr and
+            not WritePointLinesText(
+                block.data(), block.size(), out, options.threads)) {
+            return write_error();
+        }
+        for (size_t i = 0; i < block.size(); ++i) {
+            if ((first + i) % stride == 0) {
+                sample.push_back(block[i](0));
+            }
+        }
+    }
+
+    // strip s holds the points with bounds[s - 1] <= x < bounds[s]
+    Index tiles = std::max<Index>(
+        1, (n + options.tile_points - 1) / std::max<Index>(1, options.tile_points));
+    tiles = std::min<Index>(tiles, std::max<size_t>(1, sample.size()));
+    std::sort(begin(sample), end(sample));
+    std::vector<double> bounds;
+    for (Index s = 1; s < tiles; ++s) {
+        bounds.push_back(sample[s * sample.size() / tiles]);
+    }
+    stats.tiles = tiles;
+
+    // second pass: every point goes to its strip file
+    std::vector<FilePtr> strips;
+    std::vector<Index> strip_sizes(tiles);
+    for (Index s = 0; s < tiles; ++s) {
+        strips.push_back(TempFile(options.temp_dir, error));
+        if (strips.back() == nullptr) {
+            return false;
+        }
+        setvbuf(strips.back().get(), nullptr, _IOFBF, kStripBuffer);
+    }
+    if (not reader.Rewind()) {
+        return read_error();
+    }
+    for (Index first = 0;; first += block.size()) {
+        if (not reader.Read(block, kBlockPoints)) {
+            return read_error();
+        }
+        if (block.empty()) {
+            break;
+        }
+        for (size_t i = 0; i < block.size(); ++i) {
+            size_t s = std::upper_bound(begin(bounds), end(bounds), block[i](0)) -
+                       begin(bounds);
+            StripRecord record{block[i](0), block[i](1), first + Index(i)};
+            if (fwrite(&record, sizeof(record), 1, strips[s].get()) != 1) {
+                error = std::string("cannot write a strip file: ") +
+                        strerror(errno);
+                return false;
+            }
+            ++strip_sizes[s];
+        }
+    }
+
+    // the sweep, one strip in memory at a time
+    StripSweep sweep(options.threads);
+    std::vector<StripRecord> records;
+    std::vector<PointRef> strip;
+    for (Index s = 0; s < tiles; ++s) {
+        bool last = s + 1 == tiles;
+        if (strip_sizes[s] == 0 and not last) {
+            continue;
+        }
+        FILE *f = strips[s].get();
+        records.resize(strip_sizes[s]);
+        if (fflush(f) != 0 or fseek(f, 0, SEEK_SET) != 0 or
+            fread(records.data(), sizeof(StripRecord), records.size(), f) !=
+                records.size()) {
+            error = "cannot read back a strip file";
+            return false;
+        }
+        strips[s].reset();
+        // coinciding points share an x and so a strip: the one of least id
+        // stays, as in memory, and the others are dropped here rather than
+        // triangulated, where the copy kept could differ from one strip to
+        // the next and leave the frontier behind
+        std::sort(
+            begin(records), end(records),
+            [](const StripRecord &l, const StripRecord &r) {
+                return std::tie(l.x, l.y, l.id) < std::tie(r.x, r.y, r.id);
+            });
+        records.erase(
+            std::unique(
+                begin(records), end(records),
+                [](const StripRecord &l, const StripRecord &r) {
+                    return l.x == r.x and l.y == r.y;
+                }),
+            end(records));
+        strip.resize(records.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            strip[i] = {Point2D(records[i].x, records[i].y), records[i].id};
+        }
+        stats.peak_points =
+            std::max<Index>(stats.peak_points, sweep.ActiveSize() + strip.size());
+        double limit =
+            last ? std::numeric_limits<double>::infinity() : bounds[s];
+        auto final = sweep.Add(strip, limit, last);
+        stats.triangles += final.size();
+        if (out != nullptr and
+            not WriteTriangleVerticesText(final, out, options.threads)) {
+            return write_error();
+        }
+    }
+    return true;
+}
+
+} // namespace triangulation
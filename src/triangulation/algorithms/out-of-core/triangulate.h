@@ -0,0 +1,43 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <stdio.h>
+#include <string>
+
+namespace triangulation {
+
+// Triangulation of point sets larger than memory.
+//
+// The points of a binary point file are spread by x over vertical strips,
+// the tiles, of about `tile_points` points each, which go to temporary
+// files. The strips are then swept from left to right: each one is
+// triangulated together with the frontier the previous ones left behind,
+// both sides with divide and conquer and stitched along the seam between
+// their hulls. A triangle whose circumcircle lies left of every strip still
+// to come is final, as no later point can fall inside it, and is written
+// out right away. Only the points of triangles not yet final move on to the
+// next strip, so memory holds about one strip and the frontier.
+struct OutOfCoreOptions {
+    Index tile_points = Index(1) << 20;
+    // where the strip files go, each is unlinked as soon as it is created
+    std::string temp_dir = "/tmp";
+    int threads = 1;
+};
+
+struct OutOfCoreStats {
+    Index points = 0;
+    Index tiles = 0;
+    Index triangles = 0;
+    // the most points triangulated at once, a strip and the frontier
+    Index peak_points = 0;
+};
+
+// triangulates the binary point file at `path` and writes the points, then
+// one "a b c" line per counter-clockwise triangle, to `out` unless it is
+// null; the order of the triangles is the order they became final in
+bool TriangulateOutOfCore(
+    const char *path, FILE *out, const OutOfCoreOptions &options,
+    OutOfCoreStats &stats, std::string &error);
+
+} // namespace triangulation
@@ -0,0 +1,370 @@
+#include "triangulation/algorithms/sweep-hull/triangulate.h"
+
+#include "triangulation/algorithms/collinear.h"
+#include "triangulation/utility.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <numeric>
+#include <stdint.h>
+#include <tuple>
+#include <utility>
+
+namespace triangulation {
+
+namespace {
+
+using Vertex = uint32_t;
+using HalfEdge = uint32_t;
+constexpr uint32_t kNone = ~uint32_t(0);
+
+// Triangles are stored as three consecutive half-edges, each holding its
+// origin and its twin in the neighboring triangle, kNone on the hull.
+HalfEdge Next(HalfEdge h) {
+    return h % 3 == 2 ? h - 2 : h + 1;
+}
+HalfEdge Prev(HalfEdge h) {
+    return h % 3 == 0 ? h + 2 : h - 1;
+}
+
+// reorders [first, last) into the middle element, then the middles of the
+// two halves, then of the four quarters and so on
+void HalvingOrder(
+    std::vector<Vertex>::iterator first, std::vector<Vertex>::iterator last) {
+    std::vector<Vertex> items(first, last);
+    std::vector<std::pair<size_t, size_t>> ranges{{0, items.size()}};
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        auto [lo, hi] = ranges[i];
+        if (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            *first++ = items[mid];
+            ranges.emplace_back(lo, mid);
+            ranges.emplace_back(mid + 1, hi);
+        }
+    }
+}
+
+struct SweepHullImpl {
+  public:
+    SweepHullImpl(const std::vector<PointRef> &pts) : pts_(pts) {}
+
+    // false if all the points are collinear
+    bool Go() {
+        Index n = pts_.size();
+        std::vector<Vertex> order(n);
+        std::iota(begin(order), end(order), Vertex(0));
+        std::sort(begin(order), end(order), [this](Vertex l, Vertex r) {
+            return std::tie(PointOf(l)(0), PointOf(l)(1), l) <
+                   std::tie(PointOf(r)(0), PointOf(r)(1), r);
+        });
+        // of coinciding points the first one in `pts` stays, as in the
+        // other triangulators
+        order.erase(
+            std::unique(
+                begin(order), end(order),
+                [this](Vertex l, Vertex r) {
+                    return PointOf(l) == PointOf(r);
+                }),
+            end(order));
+        // Points sharing an x lie on a vertical line at the front. Swept
+        // from the bottom up, every one of them would take over the fan
+        // the one below it had onto the line before, so a lattice would
+        // cost n^1.5 flips; halving the line keeps it to n log n.
+        for (auto run = begin(order); run != end(order);) {
+            double x = PointOf(*run)(0);
+            auto run_end = std::find_if(
+                run, end(order), [&](Vertex v) { return PointOf(v)(0) != x; });
+            if (run_end - run > 2) {
+                HalvingOrder(run, run_end);
+            }
+            run = run_end;
+        }
+        Vertex i0, i1, i2;
+        if (not Seed(order, i0, i1, i2)) {
+            return false;
+        }
+        triangles_.reserve(n * 6);
+        halfedges_.reserve(n * 6);
+        hull_.resize(n);
+
+        last_ = i2;
+        if (ComputeOrientation(PointOf(i0), PointOf(i1), PointOf(i2)) ==
+            kClockwise) {
+            std::swap(i1, i2);
+        }
+        AddTriangle(i0, i1, i2, kNone, kNone, kNone);
+        Vertex seed[] = {i0, i1, i2};
+        for (int k = 0; k < 3; ++k) {
+            Vertex v = seed[k];
+            hull_[v] =
+                HullNode{seed[(k + 2) % 3], seed[(k + 1) % 3], HalfEdge(k)};
+        }
+
+        for (Vertex v : order) {
+            if (v != i0 and v != i1 and v != i2) {
+                Sweep(v);
+            }
+        }
+        return true;
+    }
+
+    std::vector<IdEdge> Edges() const {
+        std::vector<IdEdge> result;
+        result.reserve(halfedges_.size() / 2 + hull_.size());
+        for (HalfEdge h = 0; h < halfedges_.size(); ++h) {
+            if (halfedges_[h] != kNone and halfedges_[h] < h) {
+                continue;
+            }
+            Index i = pts_[triangles_[h]].id, j = pts_[triangles_[Next(h)]].id;
+            result.push_back(i < j ? IdEdge{i, j} : IdEdge{j, i});
+        }
+        return result;
+    }
+
+    // triangle t is made of the half-edges 3t, 3t + 1 and 3t + 2, the one
+    // opposite corner k being the half-edge leaving corner k + 1
+    std::vector<IdTriangle> Triangles() const {
+        std::vector<IdTriangle> result(triangles_.size() / 3);
+        for (size_t t = 0; t < result.size(); ++t) {
+            for (int k = 0; k < 3; ++k) {
+                HalfEdge twin = halfedges_[3 * t + (k + 1) % 3];
+                result[t].vertices[k] = pts_[triangles_[3 * t + k]].id;
+                result[t].neighbors[k] =
+                    twin == kNone ? kNoNeighbor : Index(twin / 3);
+            }
+        }
+        return result;
+    }
+
+  private:
+    // The convex hull as a circular list through the vertices on it, in
+    // counter-clockwise order, the same shape as ConvexHull::Node but kept
+    // in an array indexed by vertex. `edge` is the half-edge going from the
+    // vertex to the next one on the hull. Vertices taken off the hull point
+    // `next` to themselves.
+    struct HullNode {
+        Vertex prev = kNone, next = kNone;
+        HalfEdge edge = kNone;
+    };
+
+    const Point2D &PointOf(Vertex v) const {
+        return pts_[v].point;
+    }
+
+    // the first point swept, the next one apart from it and the next one
+    // off the line through both. The points in between lie on that line,
+    // the vertical one at the left or else past the second point, so every
+    // point swept after the seed is outside the hull or on it.
+    bool Seed(
+        const std::vector<Vertex> &order, Vertex &i0, Vertex &i1,
+        Vertex &i2) const {
+        auto it = begin(order);
+        i0 = *it;
+        it = std::find_if(it, end(order), [&](Vertex v) {
+            return PointOf(v) != PointOf(i0);
+        });
+        if (it == end(order)) {
+            return false;
+        }
+        i1 = *it;
+        it = std::find_if(it, end(order), [&](Vertex v) {
+            return ComputeOrientation(PointOf(i0), PointOf(i1), PointOf(v)) !=
+                   kUnknown;
+        });
+        if (it == end(order)) {
+            return false;
+        }
+        i2 = *it;
+        return true;
+    }
+
+    // whether `p` lies strictly outside the hull edge leaving `v`
+    bool Sees(const Point2D &p, Vertex v) const {
+        return ComputeOrientation(PointOf(v), PointOf(hull_[v].next), p) ==
+               kClockwise;
+    }
+
+    // whether `p` lies on the hull edge leaving `v`, ends included
+    bool OnEdge(const Point2D &p, Vertex v) const {
+        const Point2D &a = PointOf(v), &b = PointOf(hull_[v].next);
+        return ComputeOrientation(a, b, p) == kUnknown and
+               std::min(a(0), b(0)) <= p(0) and p(0) <= std::max(a(0), b(0)) and
+               std::min(a(1), b(1)) <= p(1) and p(1) <= std::max(a(1), b(1));
+    }
+
+    // adds `v` to the triangulation by connecting it to every hull edge it
+    // sees, or by splitting the hull edge it lies on
+    void Sweep(Vertex v) {
+        const Point2D &p = PointOf(v);
+
+        // The vertex swept last is the rightmost one, and `p` being at least
+        // as far right sees one of its two edges, unless both are vertical
+        // and `p` lies on their line. The hull is searched from there both
+        // ways for an edge `p` sees or lies on.
+        Vertex e = kNone;
+        for (Vertex forward = last_, backward = hull_[last_].prev;;
+             forward = hull_[forward].next, backward = hull_[backward].prev) {
+            for (Vertex candidate : {forward, backward}) {
+                if (Sees(p, candidate)) {
+                    e = candidate;
+                } else if (OnEdge(p, candidate)) {
+                    assert(p != PointOf(candidate));
+                    assert(p != PointOf(hull_[candidate].next));
+                    SplitHullEdge(v, candidate);
+                    return;
+                }
+            }
+            if (e != kNone) {
+                break;
+            }
+            if (forward == backward or hull_[forward].next == backward) {
+                assert(false); // swept inside the hull
+                return;
+            }
+        }
+
+        HalfEdge t =
+            AddTriangle(e, v, hull_[e].next, kNone, kNone, hull_[e].edge);
+        hull_[v].edge = t + 1;
+        hull_[e].edge = t;
+        Legalize(t + 2);
+
+        Vertex n = hull_[e].next;
+        while (Sees(p, n)) {
+            Vertex q = hull_[n].next;
+            t = AddTriangle(n, v, q, hull_[v].edge, kNone, hull_[n].edge);
+            hull_[v].edge = t + 1;
+            hull_[n].next = n;
+            Legalize(t + 2);
+            n = q;
+        }
+        for (Vertex q = hull_[e].prev; Sees(p, q); q = hull_[e].prev) {
+            t = AddTriangle(q, v, e, kNone, hull_[e].edge, hull_[q].edge);
+            hull_[q].edge = t;
+            hull_[e].next = e;
+            Legalize(t + 2);
+            e = q;
+        }
+
+        hull_[v].prev = e;
+        hull_[v].next = n;
+        hull_[e].next = v;
+        hull_[n].prev = v;
+        last_ = v;
+    }
+
+    // adds `v` lying on the hull edge leaving `a`: its triangle (a, b, c)
+    // becomes (a, v, c) and (v, b, c)
+    void SplitHullEdge(Vertex v, Vertex a) {
+        HalfEdge h = hull_[a].edge, hn = Next(h), hp = Prev(h);
+        Vertex b = triangles_[hn], c = triangles_[hp];
+        HalfEdge bc = halfedges_[hn];
+        triangles_[hn] = v;
+        HalfEdge t = AddTriangle(v, b, c, kNone, bc, hn);
+        if (bc == kNone) {
+            hull_[b].edge = t + 1;
+        }
+        hull_[v] = HullNode{a, b, t};
+        hull_[a].next = v;
+        hull_[b].prev = v;
+        last_ = v;
+        Legalize(hp);
+        Legalize(t + 1);
+    }
+
+    // Restores the empty circle property around a vertex just added, `h`
+    // being an edge across from it: flips the edges whose opposite vertices
+    // lie inside each other's circumcircle, and then the two edges that
+    // come across from the vertex in their place. The hull edges of the
+    // vertices whose edges move are kept up to date.
+    void Legalize(HalfEdge edge) {
+        stack_.push_back(edge);
+        while (not stack_.empty()) {
+            HalfEdge h = stack_.back();
+            stack_.pop_back();
+            HalfEdge g = halfedges_[h];
+            if (g == kNone) {
+                continue;
+            }
+            // (a, b, c) and (b, a, d) become (d, b, c) and (c, a, d)
+            HalfEdge h1 = Next(h), h2 = Prev(h), g1 = Next(g), g2 = Prev(g);
+            Vertex a = triangles_[h], c = triangles_[h2], d = triangles_[g2];
+            if (not InCircle(
+                    PointOf(a), PointOf(triangles_[h1]), PointOf(c),
+                    PointOf(d))) {
+                continue;
+            }
+            HalfEdge db = halfedges_[g2], ca = halfedges_[h2];
+            triangles_[h] = d;
+            triangles_[g] = c;
+            Link(h, db);
+            Link(g, ca);
+            Link(h2, g2);
+            if (db == kNone) {
+                hull_[d].edge = h;
+            }
+            if (ca == kNone) {
+                hull_[c].edge = g;
+            }
+            // the vertex added is c, across from h and g1 now
+            stack_.push_back(h);
+            stack_.push_back(g1);
+        }
+    }
+
+    // the triangle a, b, c with the twins of its three half-edges,
+    // returning its first half-edge
+    HalfEdge AddTriangle(
+        Vertex a, Vertex b, Vertex c, HalfEdge ab, HalfEdge bc, HalfEdge ca) {
+        HalfEdge t = triangles_.size();
+        triangles_.insert(triangles_.end(), {a, b, c});
+        halfedges_.insert(halfedges_.end(), 3, kNone);
+        Link(t, ab);
+        Link(t + 1, bc);
+        Link(t + 2, ca);
+        return t;
+    }
+
+    void Link(HalfEdge a, HalfEdge b) {
+        halfedges_[a] = b;
+        if (b != kNone) {
+            halfedges_[b] = a;
+        }
+    }
+
+    const std::vector<PointRef> &pts_;
+    std::vector<Vertex> triangles_;
+    std::vector<HalfEdge> halfedges_;
+    std::vector<HullNode> hull_;
+    std::vector<HalfEdge> stack_;
+    // the vertex swept last, the rightmost one on the hull
+    Vertex last_ = kNone;
+};
+
+} // namespace
+
+Triangulator::OutputEdges
+SweepHull::Triangulate(Triangulator::InputPoints pts) const {
+    if (pts.size() < 3) {
+        return CollinearEdges(pts);
+    }
+    SweepHullImpl driver(pts);
+    if (not driver.Go()) {
+        return CollinearEdges(pts);
+    }
+    return driver.Edges();
+}
+
+Triangulator::OutputTriangles
+SweepHull::TriangulateFaces(Triangulator::InputPoints pts) const {
+    if (pts.size() < 3) {
+        return {};
+    }
+    SweepHullImpl driver(pts);
+    if (not driver.Go()) {
+        return {};
+    }
+    return driver.Triangles();
+}
+
+} // namespace triangulation
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "triangulation/algorithms/interface.h"
+#include "triangulation/types.h"
+
+namespace triangulation {
+
+// Sweep-hull (s-hull) along a sweepline: points are added from left to
+// right, each one fanned onto the edges of the convex hull it sees, and the
+// edges across from it are flipped until the triangulation is Delaunay
+// again.
+struct SweepHull : Triangulator {
+    OutputEdges Triangulate(InputPoints points) const override;
+    OutputTriangles TriangulateFaces(InputPoints points) const override;
+};
+
+} // namespace triangulation
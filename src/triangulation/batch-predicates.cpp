@@ -0,0 +1,351 @@
+#include "triangulation/batch-predicates.h"
+
+#include "triangulation/predicates.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TRIANGULATION_X86
+#include <immintrin.h>
+#endif
+
+namespace triangulation {
+
+namespace {
+
+// Every kernel writes +1 or -1 where the filter is certain and 0 where it
+// is not; FixUncertain then settles the zeros exactly.
+
+int8_t Sign(double d) {
+    return (d > 0) - (d < 0);
+}
+
+void ScalarOrientation(
+    double ax, double ay, double bx, double by, const double *x,
+    const double *y, int n, int8_t *signs) {
+    for (int i = 0; i < n; ++i) {
+        double det_left = (ax - x[i]) * (by - y[i]);
+        double det_right = (ay - y[i]) * (bx - x[i]);
+        double det = det_left - det_right;
+        double bound = predicates::kOrientationErrorBound *
+                       (std::abs(det_left) + std::abs(det_right));
+        signs[i] = det > bound ? 1 : det < -bound ? -1 : 0;
+    }
+}
+
+void ScalarInCircle(
+    double ax, double ay, double bx, double by, const double *x,
+    const double *y, int n, int8_t *signs) {
+    for (int i = 0; i < n; ++i) {
+        double dx = x[i + 1], dy = y[i + 1];
+        double adx = ax - dx, ady = ay - dy, bdx = bx - dx, bdy = by - dy,
+               cdx = x[i] - dx, cdy = y[i] - dy;
+        double bdx_cdy = bdx * cdy, cdx_bdy = cdx * bdy;
+        double cdx_ady = cdx * ady, adx_cdy = adx * cdy;
+        double adx_bdy = adx * bdy, bdx_ady = bdx * ady;
+        double a_lift = adx * adx + ady * ady;
+        double b_lift = bdx * bdx + bdy * bdy;
+        double c_lift = cdx * cdx + cdy * cdy;
+        double det = a_lift * (bdx_cdy - cdx_bdy) +
+                     b_lift * (cdx_ady - adx_cdy) +
+                     c_lift * (adx_bdy - bdx_ady);
+        double permanent = (std::abs(bdx_cdy) + std::abs(cdx_bdy)) * a_lift +
+                           (std::abs(cdx_ady) + std::abs(adx_cdy)) * b_lift +
+                           (std::abs(adx_bdy) + std::abs(bdx_ady)) * c_lift;
+        double bound = predicates::kInCircleErrorBound * permanent;
+        signs[i] = det > bound ? 1 : det < -bound ? -1 : 0;
+    }
+}
+
+#ifdef TRIANGULATION_X86
+
+__attribute__((target("avx2"))) void Avx2Orientation(
+    double ax, double ay, double bx, double by, const double *x,
+    const double *y, int n, int8_t *signs) {
+    const __m256d abs_mask = _mm256_castsi256_pd(
+        _mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d vax = _mm256_set1_pd(ax), vay = _mm256_set1_pd(ay),
+                  vbx = _mm256_set1_pd(bx), vby = _mm256_set1_pd(by),
+                  err = _mm256_set1_pd(predicates::kOrientationErrorBound);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cx = _mm256_loadu_pd(x + i), cy = _mm256_loadu_pd(y + i);
+        __m256d left = _mm256_mul_pd(
+            _mm256_sub_pd(vax, cx), _mm256_sub_pd(vby, cy));
+        __m256d right = _mm256_mul_pd(
+            _mm256_sub_pd(vay, cy), _mm256_sub_pd(vbx, cx));
+        __m256d det = _mm256_sub_pd(left, right);
+        __m256d bound = _mm256_mul_pd(
+            err, _mm256_add_pd(
+                     _mm256_and_pd(left, abs_mask),
+                     _mm256_and_pd(right, abs_mask)));
+        int pos = _mm256_movemask_pd(_mm256_cmp_pd(det, bound, _CMP_GT_OQ));
+        int neg = _mm256_movemask_pd(_mm256_cmp_pd(
+            det, _mm256_sub_pd(_mm256_setzero_pd(), bound), _CMP_LT_OQ));
+        for (int k = 0; k < 4; ++k) {
+            signs[i + k] = ((pos >> k) & 1) - ((neg >> k) & 1);
+        }
+    }
+    // the scalar tail is plain sse code, leaving the upper halves of the
+    // ymm registers dirty would stall it
+    _mm256_zeroupper();
+    ScalarOrientation(ax, ay, bx, by, x + i, y + i, n - i, signs + i);
+}
+
+__attribute__((target("avx2"))) void Avx2InCircle(
+    double ax, double ay, double bx, double by, const double *x,
+    const double *y, int n, int8_t *signs) {
+    const __m256d abs_mask = _mm256_castsi256_pd(
+        _mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d vax = _mm256_set1_pd(ax), vay = _mm256_set1_pd(ay),
+                  vbx = _mm256_set1_pd(bx), vby = _mm256_set1_pd(by),
+                  err = _mm256_set1_pd(predicates::kInCircleErrorBound);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_loadu_pd(x + i + 1), dy = _mm256_loadu_pd(y + i + 1);
+        __m256d adx = _mm256_sub_pd(vax, dx), ady = _mm256_sub_pd(vay, dy);
+        __m256d bdx = _mm256_sub_pd(vbx, dx), bdy = _mm256_sub_pd(vby, dy);
+        __m256d cdx = _mm256_sub_pd(_mm256_loadu_pd(x + i), dx);
+        __m256d cdy = _mm256_sub_pd(_mm256_loadu_pd(y + i), dy);
+
+        __m256d bdx_cdy = _mm256_mul_pd(bdx, cdy),
+                cdx_bdy = _mm256_mul_pd(cdx, bdy);
+        __m256d cdx_ady = _mm256_mul_pd(cdx, ady),
+                adx_cdy = _mm256_mul_pd(adx, cdy);
+        __m256d adx_bdy = _mm256_mul_pd(adx, bdy),
+                bdx_ady = _mm256_mul_pd(bdx, ady);
+        __m256d a_lift = _mm256_add_pd(
+            _mm256_mul_pd(adx, adx), _mm256_mul_pd(ady, ady));
+        __m256d b_lift = _mm256_add_pd(
+            _mm256_mul_pd(bdx, bdx), _mm256_mul_pd(bdy, bdy));
+        __m256d c_lift = _mm256_add_pd(
+            _mm256_mul_pd(cdx, cdx), _mm256_mul_pd(cdy, cdy));
+
+        __m256d det = _mm256_add_pd(
+            _mm256_add_pd(
+                _mm256_mul_pd(a_lift, _mm256_sub_pd(bdx_cdy, cdx_bdy)),
+                _mm256_mul_pd(b_lift, _mm256_sub_pd(cdx_ady, adx_cdy))),
+            _mm256_mul_pd(c_lift, _mm256_sub_pd(adx_bdy, bdx_ady)));
+        __m256d a_cofactor = _mm256_add_pd(
+            _mm256_and_pd(bdx_cdy, abs_mask), _mm256_and_pd(cdx_bdy, abs_mask));
+        __m256d b_cofactor = _mm256_add_pd(
+            _mm256_and_pd(cdx_ady, abs_mask), _mm256_and_pd(adx_cdy, abs_mask));
+        __m256d c_cofactor = _mm256_add_pd(
+            _mm256_and_pd(adx_bdy, abs_mask), _mm256_and_pd(bdx_ady, abs_mask));
+        __m256d permanent = _mm256_add_pd(
+            _mm256_add_pd(
+                _mm256_mul_pd(a_cofactor, a_lift),
+                _mm256_mul_pd(b_cofactor, b_lift)),
+            _mm256_mul_pd(c_cofactor, c_lift));
+        __m256d bound = _mm256_mul_pd(err, permanent);
+
+        int pos = _mm256_movemask_pd(_mm256_cmp_pd(det, bound, _CMP_GT_OQ));
+        int neg = _mm256_movemask_pd(_mm256_cmp_pd(
+            det, _mm256_sub_pd(_mm256_setzero_pd(), bound), _CMP_LT_OQ));
+        for (int k = 0; k < 4; ++k) {
+            signs[i + k] = ((pos >> k) & 1) - ((neg >> k) & 1);
+        }
+    }
+    _mm256_zeroupper();
+    ScalarInCircle(ax, ay, bx, by, x + i, y + i, n - i, signs + i);
+}
+
+void Sse2Orientation(
+    double ax, double ay, double bx, double by, const double *x,
+    const double *y, int n, int8_t *signs) {
+    const __m128d abs_mask =
+        _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d vax = _mm_set1_pd(ax), vay = _mm_set1_pd(ay),
+                  vbx = _mm_set1_pd(bx), vby = _mm_set1_pd(by),
+                  err = _mm_set1_pd(predicates::kOrientationErrorBound);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d cx = _mm_loadu_pd(x + i), cy = _mm_loadu_pd(y + i);
+        __m128d left = _mm_mul_pd(_mm_sub_pd(vax, cx), _mm_sub_pd(vby, cy));
+        __m128d right = _mm_mul_pd(_mm_sub_pd(vay, cy), _mm_sub_pd(vbx, cx));
+        __m128d det = _mm_sub_pd(left, right);
+        __m128d bound = _mm_mul_pd(
+            err,
+            _mm_add_pd(_mm_and_pd(left, abs_mask), _mm_and_pd(right, abs_mask)));
+        int pos = _mm_movemask_pd(_mm_cmpgt_pd(det, bound));
+        int neg = _mm_movemask_pd(
+            _mm_cmplt_pd(det, _mm_sub_pd(_mm_setzero_pd(), bound)));
+        for (int k = 0; k < 2; ++k) {
+            signs[i + k] = ((pos >> k) & 1) - ((neg >> k) & 1);
+        }
+    }
+    ScalarOrientation(ax, ay, bx, by, x + i, y + i, n - i, signs + i);
+}
+
+void Sse2InCircle(
+    double ax, double ay, double bx, double by, const double *x,
+    const double *y, int n, int8_t *signs) {
+    const __m128d abs_mask =
+        _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d vax = _mm_set1_pd(ax), vay = _mm_set1_pd(ay),
+                  vbx = _mm_set1_pd(bx), vby = _mm_set1_pd(by),
+                  err = _mm_set1_pd(predicates::kInCircleErrorBound);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d dx = _mm_loadu_pd(x + i + 1), dy = _mm_loadu_pd(y + i + 1);
+        __m128d adx = _mm_sub_pd(vax, dx), ady = _mm_sub_pd(vay, dy);
+        __m128d bdx = _mm_sub_pd(vbx, dx), bdy = _mm_sub_pd(vby, dy);
+        __m128d cdx = _mm_sub_pd(_mm_loadu_pd(x + i), dx);
+        __m128d cdy = _mm_sub_pd(_mm_loadu_pd(y + i), dy);
+
+        __m128d bdx_cdy = _mm_mul_pd(bdx, cdy), cdx_bdy = _mm_mul_pd(cdx, bdy);
+        __m128d cdx_ady = _mm_mul_pd(cdx, ady), adx_cdy = _mm_mul_pd(adx, cdy);
+        __m128d adx_bdy = _mm_mul_pd(adx, bdy), bdx_ady = _mm_mul_pd(bdx, ady);
+        __m128d a_lift =
+            _mm_add_pd(_mm_mul_pd(adx, adx), _mm_mul_pd(ady, ady));
+        __m128d b_lift =
+            _mm_add_pd(_mm_mul_pd(bdx, bdx), _mm_mul_pd(bdy, bdy));
+        __m128d c_lift =
+            _mm_add_pd(_mm_mul_pd(cdx, cdx), _mm_mul_pd(cdy, cdy));
+
+        __m128d det = _mm_add_pd(
+            _mm_add_pd(
+                _mm_mul_pd(a_lift, _mm_sub_pd(bdx_cdy, cdx_bdy)),
+                _mm_mul_pd(b_lift, _mm_sub_pd(cdx_ady, adx_cdy))),
+            _mm_mul_pd(c_lift, _mm_sub_pd(adx_bdy, bdx_ady)));
+        __m128d a_cofactor = _mm_add_pd(
+            _mm_and_pd(bdx_cdy, abs_mask), _mm_and_pd(cdx_bdy, abs_mask));
+        __m128d b_cofactor = _mm_add_pd(
+            _mm_and_pd(cdx_ady, abs_mask), _mm_and_pd(adx_cdy, abs_mask));
+        __m128d c_cofactor = _mm_add_pd(
+            _mm_and_pd(adx_bdy, abs_mask), _mm_and_pd(bdx_ady, abs_mask));
+        __m128d permanent = _mm_add_pd(
+            _mm_add_pd(
+                _mm_mul_pd(a_cofactor, a_lift), _mm_mul_pd(b_cofactor, b_lift)),
+            _mm_mul_pd(c_cofactor, c_lift));
+        __m128d bound = _mm_mul_pd(err, permanent);
+
+        int pos = _mm_movemask_pd(_mm_cmpgt_pd(det, bound));
+        int neg = _mm_movemask_pd(
+            _mm_cmplt_pd(det, _mm_sub_pd(_mm_setzero_pd(), bound)));
+        for (int k = 0; k < 2; ++k) {
+            signs[i + k] = ((pos >> k) & 1) - ((neg >> k) & 1);
+        }
+    }
+    ScalarInCircle(ax, ay, bx, by, x + i, y + i, n - i, signs + i);
+}
+
+#endif
+
+using Kernel = void (*)(
+    double, double, double, double, const double *, const double *, int,
+    int8_t *);
+
+struct Kernels {
+    BatchKernel kind;
+    Kernel orientation;
+    Kernel in_circle;
+};
+
+bool Supported(BatchKernel kernel) {
+#ifdef TRIANGULATION_X86
+    __builtin_cpu_init();
+    switch (kernel) {
+    case BatchKernel::kAvx2:
+        return __builtin_cpu_supports("avx2");
+    case BatchKernel::kSse2:
+        return __builtin_cpu_supports("sse2");
+    case BatchKernel::kScalar:
+        return true;
+    }
+    return false;
+#else
+    return kernel == BatchKernel::kScalar;
+#endif
+}
+
+Kernels KernelsOf(BatchKernel kernel) {
+    switch (kernel) {
+#ifdef TRIANGULATION_X86
+    case BatchKernel::kAvx2:
+        return Kernels{kernel, Avx2Orientation, Avx2InCircle};
+    case BatchKernel::kSse2:
+        return Kernels{kernel, Sse2Orientation, Sse2InCircle};
+#endif
+    default:
+        return Kernels{BatchKernel::kScalar, ScalarOrientation, ScalarInCircle};
+    }
+}
+
+Kernels BestKernels() {
+    for (auto kernel : {BatchKernel::kAvx2, BatchKernel::kSse2}) {
+        if (Supported(kernel)) {
+            return KernelsOf(kernel);
+        }
+    }
+    return KernelsOf(BatchKernel::kScalar);
+}
+
+Kernels active = BestKernels();
+
+} // namespace
+
+BatchKernel ActiveBatchKernel() {
+    return active.kind;
+}
+
+const char *BatchKernelName(BatchKernel kernel) {
+    switch (kernel) {
+    case BatchKernel::kAvx2:
+        return "avx2";
+    case BatchKernel::kSse2:
+        return "sse2";
+    case BatchKernel::kScalar:
+        return "scalar";
+    }
+    return "unknown";
+}
+
+bool SelectBatchKernel(BatchKernel kernel) {
+    if (not Supported(kernel)) {
+        return false;
+    }
+    active = KernelsOf(kernel);
+    return true;
+}
+
+void BatchOrientation(
+    const Point2D &a, const Point2D &b, const PointBatch &batch,
+    std::vector<int8_t> &signs) {
+    int n = batch.Size();
+    STATS_ADD(kOrientationCalls, n);
+    signs.resize(n);
+    active.orientation(
+        a(0), a(1), b(0), b(1), batch.x.data(), batch.y.data(), n,
+        signs.data());
+    for (int i = 0; i < n; ++i) {
+        if (signs[i] == 0) {
+            signs[i] = Sign(predicates::OrientationExact(
+                a(0), a(1), b(0), b(1), batch.x[i], batch.y[i]));
+        }
+    }
+}
+
+void BatchInCircleOfNeighbors(
+    const Point2D &a, const Point2D &b, const PointBatch &batch,
+    std::vector<int8_t> &signs) {
+    int n = batch.Size() - 1;
+    if (n <= 0) {
+        signs.clear();
+        return;
+    }
+    STATS_ADD(kInCircleCalls, n);
+    signs.resize(n);
+    active.in_circle(
+        a(0), a(1), b(0), b(1), batch.x.data(), batch.y.data(), n,
+        signs.data());
+    for (int i = 0; i < n; ++i) {
+        if (signs[i] == 0) {
+            signs[i] = Sign(predicates::InCircleExact(
+                a(0), a(1), b(0), b(1), batch.x[i], batch.y[i],
+                batch.x[i + 1], batch.y[i + 1]));
+        }
+    }
+}
+
+} // namespace triangulation
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+// Coordinates of a batch of points in two contiguous arrays, the layout the
+// vectorized predicates below read from.
+struct PointBatch {
+    std::vector<double> x, y;
+
+    void Clear() {
+        x.clear();
+        y.clear();
+    }
+    void Push(const Point2D &p) {
+        x.push_back(p(0));
+        y.push_back(p(1));
+    }
+    int Size() const {
+        return x.size();
+    }
+};
+
+// Batched versions of the predicates in predicates.h. Each lane runs the
+// same floating-point filter, and the lanes it cannot decide are redone
+// one by one with the exact scalar code, so the signs are exact.
+//
+// The widest kernel the cpu supports is picked at startup.
+enum class BatchKernel { kScalar, kSse2, kAvx2 };
+
+BatchKernel ActiveBatchKernel();
+
+const char *BatchKernelName(BatchKernel kernel);
+
+// makes every later batch call use `kernel`, returns false and changes
+// nothing if the cpu does not support it
+bool SelectBatchKernel(BatchKernel kernel);
+
+// signs[i] = sign of OrientationDeterminant(a, b, batch[i])
+void BatchOrientation(
+    const Point2D &a, const Point2D &b, const PointBatch &batch,
+    std::vector<int8_t> &signs);
+
+// signs[i] = sign of InCircleDeterminant(a, b, batch[i], batch[i + 1]) for
+// every pair of neighbors in the batch
+void BatchInCircleOfNeighbors(
+    const Point2D &a, const Point2D &b, const PointBatch &batch,
+    std::vector<int8_t> &signs);
+
+} // namespace triangulation
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "triangulation/batch-predicates.h"
+#include "triangulation/stats.h"
+#include "triangulation/types.h"
+#include "triangulation/utility.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+// The type a triangulation keeps its coordinates in, and the predicates
+// over them. Points reach the predicates widened to a Point2D, which holds
+// a float or an int32 exactly, so the stored type decides how many bytes a
+// point takes and which arithmetic decides its signs.
+template <typename T>
+struct CoordinateTraits;
+
+// filtered floating point, falling back to exact expansion arithmetic
+template <>
+struct CoordinateTraits<double> {
+    // the coordinate a double input is stored as
+    static double Round(double x) {
+        return x;
+    }
+
+    static Orientation
+    Orient(const Point2D &a, const Point2D &b, const Point2D &c) {
+        return ComputeOrientation(a, b, c);
+    }
+
+    static bool InCircle(
+        const Point2D &a, const Point2D &b, const Point2D &c,
+        const Point2D &d) {
+        return triangulation::InCircle(a, b, c, d);
+    }
+
+    static void BatchOrientation(
+        const Point2D &a, const Point2D &b, const PointBatch &batch,
+        std::vector<int8_t> &signs) {
+        triangulation::BatchOrientation(a, b, batch, signs);
+    }
+
+    static void BatchInCircleOfNeighbors(
+        const Point2D &a, const Point2D &b, const PointBatch &batch,
+        std::vector<int8_t> &signs) {
+        triangulation::BatchInCircleOfNeighbors(a, b, batch, signs);
+    }
+};
+
+// floats widen to doubles without rounding, so the double predicates are
+// exact on them; only the storage is halved
+template <>
+struct CoordinateTraits<float> : CoordinateTraits<double> {
+    static double Round(double x) {
+        // GCC 12 takes the narrowing and widening of an x and y pair it
+        // vectorized for no change at all, and drops both; a volatile
+        // float makes the narrowing happen
+        volatile float f = x;
+        return f;
+    }
+};
+
+// Integer grid coordinates with exact integer predicates and no filter.
+// Coordinates within kMaxMagnitude differ by at most 2^30, so the
+// orientation products fit an int64 and the in-circle terms, each a lift
+// below 2^61 times a cross product below 2^61, fit an __int128.
+template <>
+struct CoordinateTraits<int32_t> {
+    static constexpr double kMaxMagnitude = 1 << 29;
+
+    // whether the closest grid point lies within kMaxMagnitude, which NaNs
+    // and infinities do not
+    static bool Fits(double x) {
+        return std::abs(std::nearbyint(x)) <= kMaxMagnitude;
+    }
+
+    // the closest grid point, which must fit
+    static double Round(double x) {
+        double r = std::nearbyint(x);
+        assert(std::abs(r) <= kMaxMagnitude);
+        return r;
+    }
+
+    static int64_t OrientationDeterminant(
+        const Point2D &a, const Point2D &b, const Point2D &c) {
+        STATS_COUNT(kOrientationCalls);
+        int64_t acx = int64_t(a(0)) - int64_t(c(0));
+        int64_t acy = int64_t(a(1)) - int64_t(c(1));
+        int64_t bcx = int64_t(b(0)) - int64_t(c(0));
+        int64_t bcy = int64_t(b(1)) - int64_t(c(1));
+        return acx * bcy - acy * bcx;
+    }
+
+    static __int128 InCircleDeterminant(
+        const Point2D &a, const Point2D &b, const Point2D &c,
+        const Point2D &d) {
+        STATS_COUNT(kInCircleCalls);
+        int64_t adx = int64_t(a(0)) - int64_t(d(0));
+        int64_t ady = int64_t(a(1)) - int64_t(d(1));
+        int64_t bdx = int64_t(b(0)) - int64_t(d(0));
+        int64_t bdy = int64_t(b(1)) - int64_t(d(1));
+        int64_t cdx = int64_t(c(0)) - int64_t(d(0));
+        int64_t cdy = int64_t(c(1)) - int64_t(d(1));
+        int64_t a_lift = adx * adx + ady * ady;
+        int64_t b_lift = bdx * bdx + bdy * bdy;
+        int64_t c_lift = cdx * cdx + cdy * cdy;
+        return __int128(a_lift) * (bdx * cdy - cdx * bdy) +
+               __int128(b_lift) * (cdx * ady - adx * cdy) +
+               __int128(c_lift) * (adx * bdy - bdx * ady);
+    }
+
+    static Orientation
+    Orient(const Point2D &a, const Point2D &b, const Point2D &c) {
+        int64_t d = OrientationDeterminant(a, b, c);
+        if (d < 0) return Orientation::kClockwise;
+        if (d > 0) return Orientation::kCounterClockwise;
+        return Orientation::kUnknown;
+    }
+
+    static bool InCircle(
+        const Point2D &a, const Point2D &b, const Point2D &c,
+        const Point2D &d) {
+        return InCircleDeterminant(a, b, c, d) > 0;
+    }
+
+    // the exact products leave no filter for lanes to share, the batches
+    // are plain loops
+    static void BatchOrientation(
+        const Point2D &a, const Point2D &b, const PointBatch &batch,
+        std::vector<int8_t> &signs) {
+        signs.resize(batch.Size());
+        for (int i = 0; i < batch.Size(); ++i) {
+            int64_t d = OrientationDeterminant(
+                a, b, Point2D(batch.x[i], batch.y[i]));
+            signs[i] = (d > 0) - (d < 0);
+        }
+    }
+
+    static void BatchInCircleOfNeighbors(
+        const Point2D &a, const Point2D &b, const PointBatch &batch,
+        std::vector<int8_t> &signs) {
+        signs.resize(std::max(batch.Size() - 1, 0));
+        for (int i = 0; i + 1 < batch.Size(); ++i) {
+            __int128 d = InCircleDeterminant(
+                a, b, Point2D(batch.x[i], batch.y[i]),
+                Point2D(batch.x[i + 1], batch.y[i + 1]));
+            signs[i] = (d > 0) - (d < 0);
+        }
+    }
+};
+
+} // namespace triangulation
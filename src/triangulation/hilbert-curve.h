@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <utility>
+
+namespace triangulation {
+
+// position of cell (x, y) along the Hilbert curve filling the 2^order
+// square grid, for an order of at most 32
+inline uint64_t HilbertIndex(uint32_t x, uint32_t y, int order) {
+    uint64_t d = 0;
+    for (uint32_t s = uint32_t(uint64_t(1) << (order - 1)); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0, ry = (y & s) > 0;
+        d += uint64_t(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+} // namespace triangulation
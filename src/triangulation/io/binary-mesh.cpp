@@ -0,0 +1,509 @@
+#include "triangulation/io/binary-mesh.h"
+
+#include "triangulation/hilbert-curve.h"
+#include "triangulation/io/mapped-file.h"
+#include "triangulation/parallel/radix-sort.h"
+#include "triangulation/parallel/work-stealing-pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace triangulation {
+
+namespace {
+
+constexpr char kMeshMagic[4] = {'D', 'T', 'M', 'B'};
+
+static_assert(
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+    "mesh files are read in place and assume a little endian host");
+
+// elements per block; the first one of a block is coded against 0, the
+// others against the one before
+constexpr uint32_t kBlockSize = 1 << 12;
+
+// the grid the points are ordered along is 2^kHilbertOrder cells wide
+constexpr int kHilbertOrder = 16;
+
+// points copied into the write buffer at a time
+constexpr size_t kPointsPerWrite = 1 << 16;
+
+// the longest varint of a uint64_t
+constexpr size_t kMaxVarint = 10;
+
+size_t AlignTo8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+uint8_t *PutVarint(uint8_t *out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = uint8_t(value);
+    return out;
+}
+
+// null when the varint runs past `end` or does not fit a uint64_t
+const uint8_t *
+GetVarint(const uint8_t *p, const uint8_t *end, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 and p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+// small magnitudes of either sign to small unsigned numbers
+uint64_t ZigZag(int64_t value) {
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+// the vertex numbers of the points along a Hilbert curve over their
+// bounding box
+struct Numbering {
+    // the input index of every vertex
+    std::vector<uint32_t> order;
+    // the vertex of every input index
+    std::vector<uint32_t> vertex;
+};
+
+Numbering AlongHilbertCurve(const PointSet &pts, WorkStealingPool *workers) {
+    Index n = pts.Size();
+    Numbering result;
+    if (n == 0) {
+        return result;
+    }
+    Point2D lo = pts[0], hi = pts[0];
+    for (Index i = 1; i < n; ++i) {
+        lo = lo.cwiseMin(pts[i]);
+        hi = hi.cwiseMax(pts[i]);
+    }
+    double cells = (1u << kHilbertOrder) - 1;
+    Point2D extent = hi - lo;
+    double scale_x = extent(0) > 0 ? cells / extent(0) : 0;
+    double scale_y = extent(1) > 0 ? cells / extent(1) : 0;
+    std::vector<RadixItem> items(n), buffer;
+    for (Index i = 0; i < n; ++i) {
+        uint32_t x = (pts[i](0) - lo(0)) * scale_x;
+        uint32_t y = (pts[i](1) - lo(1)) * scale_y;
+        items[i] = {HilbertIndex(x, y, kHilbertOrder), uint32_t(i)};
+    }
+    RadixSort(items, buffer, workers);
+    result.order.resize(n);
+    result.vertex.resize(n);
+    for (Index v = 0; v < n; ++v) {
+        result.order[v] = items[v].index;
+        result.vertex[items[v].index] = v;
+    }
+    return result;
+}
+
+bool WriteHeaderAndPoints(
+    const PointSet &pts, const Numbering &numbering, bool faces,
+    MeshEncoding encoding, size_t count, FILE *f) {
+    BinaryMeshHeader header;
+    memcpy(header.magic, kMeshMagic, sizeof(kMeshMagic));
+    header.kind = faces;
+    header.encoding = uint32_t(encoding);
+    header.block_size = kBlockSize;
+    header.point_count = pts.Size();
+    header.element_count = count;
+    if (fwrite(&header, sizeof(header), 1, f) != 1) {
+        return false;
+    }
+    std::vector<Point2D> buffer;
+    for (size_t begin = 0; begin < numbering.order.size();
+         begin += kPointsPerWrite) {
+        size_t end = std::min(numbering.order.size(), begin + kPointsPerWrite);
+        buffer.resize(end - begin);
+        for (size_t v = begin; v < end; ++v) {
+            buffer[v - begin] = pts[numbering.order[v]];
+        }
+        if (fwrite(buffer.data(), sizeof(Point2D), buffer.size(), f) !=
+            buffer.size()) {
+            return false;
+        }
+    }
+    const auto &ids = numbering.order;
+    static const uint8_t zeros[8] = {};
+    size_t padding = pts.Size() % 2 * sizeof(uint32_t);
+    return fwrite(ids.data(), sizeof(uint32_t), ids.size(), f) ==
+               ids.size() and
+           fwrite(zeros, 1, padding, f) == padding;
+}
+
+// Writes `count` elements in blocks, `encode(begin, end, out)` filling
+// `out` with the elements [begin, end). The blocks of a batch are encoded
+// concurrently on `workers` and then written in order, followed in a
+// packed file by the table of where they start.
+template <typename Encode>
+bool WriteElements(
+    size_t count, MeshEncoding encoding, FILE *f, WorkStealingPool *workers,
+    const Encode &encode) {
+    size_t blocks = (count + kBlockSize - 1) / kBlockSize;
+    size_t batch = workers ? 2 * workers->Size() : 1;
+    std::vector<std::vector<uint8_t>> buffers(batch);
+    auto encode_block = [&](size_t block, std::vector<uint8_t> &out) {
+        encode(
+            block * kBlockSize, std::min(count, (block + 1) * kBlockSize),
+            out);
+    };
+    std::vector<uint64_t> offsets{0};
+    for (size_t first = 0; first < blocks; first += batch) {
+        size_t last = std::min(blocks, first + batch);
+        ForEachIndex(workers, first, last, 1, [&](size_t block) {
+            encode_block(block, buffers[block - first]);
+        });
+        for (size_t block = first; block < last; ++block) {
+            const auto &buffer = buffers[block - first];
+            if (fwrite(buffer.data(), 1, buffer.size(), f) != buffer.size()) {
+                return false;
+            }
+            offsets.push_back(offsets.back() + buffer.size());
+        }
+    }
+    if (encoding == MeshEncoding::kPlain) {
+        return true;
+    }
+    static const uint8_t zeros[8] = {};
+    size_t padding = AlignTo8(offsets.back()) - offsets.back();
+    return fwrite(zeros, 1, padding, f) == padding and
+           fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), f) ==
+               offsets.size();
+}
+
+} // namespace
+
+bool WriteBinaryMeshEdges(
+    const PointSet &pts, const std::vector<IdEdge> &edges,
+    MeshEncoding encoding, FILE *f, int threads) {
+    if (uint64_t(pts.Size()) > UINT32_MAX) {
+        return false;
+    }
+    auto workers = MakeWorkers(threads);
+    Numbering numbering = AlongHilbertCurve(pts, workers.get());
+    // an edge (a, b) is the key a << 32 | b
+    std::vector<RadixItem> items(edges.size()), buffer;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        uint64_t a = numbering.vertex[edges[i].p1];
+        uint64_t b = numbering.vertex[edges[i].p2];
+        items[i] = {std::min(a, b) << 32 | std::max(a, b), 0};
+    }
+    RadixSort(items, buffer, workers.get());
+    std::vector<RadixItem>().swap(buffer);
+
+    if (not WriteHeaderAndPoints(
+            pts, numbering, false, encoding, edges.size(), f)) {
+        return false;
+    }
+    return WriteElements(
+        items.size(), encoding, f, workers.get(),
+        [&](size_t begin, size_t end, std::vector<uint8_t> &out) {
+            if (encoding == MeshEncoding::kPlain) {
+                out.resize((end - begin) * 2 * sizeof(uint32_t));
+                uint32_t *record = (uint32_t *)out.data();
+                for (size_t i = begin; i < end; ++i) {
+                    *record++ = items[i].key >> 32;
+                    *record++ = uint32_t(items[i].key);
+                }
+                return;
+            }
+            out.resize((end - begin) * 2 * kMaxVarint);
+            uint8_t *p = out.data();
+            uint64_t previous = 0;
+            for (size_t i = begin; i < end; ++i) {
+                uint64_t a = items[i].key >> 32, b = uint32_t(items[i].key);
+                p = PutVarint(p, a - previous);
+                p = PutVarint(p, b - a);
+                previous = a;
+            }
+            out.resize(p - out.data());
+        });
+}
+
+bool WriteBinaryMeshTriangles(
+    const PointSet &pts, const std::vector<IdTriangle> &triangles,
+    MeshEncoding encoding, FILE *f, int threads) {
+    if (uint64_t(pts.Size()) > UINT32_MAX or triangles.size() > INT32_MAX) {
+        return false;
+    }
+    auto workers = MakeWorkers(threads);
+    Numbering numbering = AlongHilbertCurve(pts, workers.get());
+    const auto &vertex = numbering.vertex;
+    // where the least vertex of every triangle is among its corners
+    std::vector<uint8_t> first(triangles.size());
+    std::vector<RadixItem> items(triangles.size()), buffer;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        const Index *v = triangles[t].vertices;
+        int k = 0;
+        for (int j = 1; j < 3; ++j) {
+            k = vertex[v[j]] < vertex[v[k]] ? j : k;
+        }
+        first[t] = k;
+        items[t] = {vertex[v[k]], uint32_t(t)};
+    }
+    RadixSort(items, buffer, workers.get());
+    std::vector<RadixItem>().swap(buffer);
+    std::vector<int32_t> renumbered(triangles.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        renumbered[items[i].index] = i;
+    }
+    // triangle i of the file, turned to start at its least vertex
+    auto record = [&](size_t i) {
+        uint32_t t = items[i].index;
+        const IdTriangle &from = triangles[t];
+        MeshTriangle m;
+        for (int k = 0; k < 3; ++k) {
+            int j = (first[t] + k) % 3;
+            m.vertices[k] = vertex[from.vertices[j]];
+            m.neighbors[k] = from.neighbors[j] == kNoNeighbor
+                                 ? -1
+                                 : renumbered[from.neighbors[j]];
+        }
+        return m;
+    };
+
+    if (not WriteHeaderAndPoints(
+            pts, numbering, true, encoding, triangles.size(), f)) {
+        return false;
+    }
+    return WriteElements(
+        items.size(), encoding, f, workers.get(),
+        [&](size_t begin, size_t end, std::vector<uint8_t> &out) {
+            if (encoding == MeshEncoding::kPlain) {
+                out.resize((end - begin) * sizeof(MeshTriangle));
+                MeshTriangle *records = (MeshTriangle *)out.data();
+                for (size_t i = begin; i < end; ++i) {
+                    records[i - begin] = record(i);
+                }
+                return;
+            }
+            out.resize((end - begin) * 6 * kMaxVarint);
+            uint8_t *p = out.data();
+            uint64_t previous = 0;
+            for (size_t i = begin; i < end; ++i) {
+                MeshTriangle m = record(i);
+                uint64_t a = m.vertices[0];
+                p = PutVarint(p, a - previous);
+                p = PutVarint(p, m.vertices[1] - a);
+                p = PutVarint(p, m.vertices[2] - a);
+                for (int32_t n : m.neighbors) {
+                    p = PutVarint(
+                        p, n < 0 ? 0 : ZigZag(int64_t(n) - int64_t(i)));
+                }
+                previous = a;
+            }
+            out.resize(p - out.data());
+        });
+}
+
+MeshFile::~MeshFile() {
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+    }
+}
+
+bool MeshFile::Open(const char *path, std::string &error) {
+    map_ = MapFile(path, map_size_, error);
+    if (map_ == nullptr) {
+        return false;
+    }
+    auto invalid = [&](const char *what) {
+        error = std::string(path) + ": " + what;
+        return false;
+    };
+    if (map_size_ < sizeof(header_)) {
+        return invalid("truncated header");
+    }
+    memcpy(&header_, map_, sizeof(header_));
+    if (memcmp(header_.magic, kMeshMagic, sizeof(kMeshMagic)) != 0) {
+        return invalid("not a binary mesh file");
+    }
+    if (header_.kind > 1 or header_.encoding > 1 or header_.block_size == 0) {
+        return invalid("unsupported kind, encoding or block size");
+    }
+    const uint8_t *base = (const uint8_t *)map_;
+    uint64_t n = header_.point_count;
+    if (n > (map_size_ - sizeof(header_)) /
+                (sizeof(Point2D) + sizeof(uint32_t))) {
+        return invalid("the points do not fit in the file");
+    }
+    points_ = (const Point2D *)(base + sizeof(header_));
+    ids_ = (const uint32_t *)(points_ + n);
+    size_t start = AlignTo8((const uint8_t *)(ids_ + n) - base);
+    if (start > map_size_) {
+        return invalid("the points do not fit in the file");
+    }
+    elements_ = base + start;
+    size_t size = map_size_ - start;
+
+    // a plain element takes a whole record, a packed one a byte a number
+    uint64_t count = header_.element_count;
+    size_t least = Faces() ? 6 : 2;
+    if (Encoding() == MeshEncoding::kPlain) {
+        least = Faces() ? sizeof(MeshTriangle) : 2 * sizeof(uint32_t);
+    }
+    if (count > size / least) {
+        return invalid("the elements do not fit in the file");
+    }
+    blocks_ = (count + header_.block_size - 1) / header_.block_size;
+    if (Encoding() == MeshEncoding::kPlain) {
+        return true;
+    }
+    size_t table = (blocks_ + 1) * sizeof(uint64_t);
+    if (table > size or (size - table) % 8 != 0) {
+        return invalid("the block offsets do not fit in the file");
+    }
+    offsets_ = (const uint64_t *)(elements_ + size - table);
+    bool ordered = offsets_[0] == 0 and
+                   AlignTo8(offsets_[blocks_]) == size - table and
+                   offsets_[blocks_] <= size - table;
+    for (size_t b = 0; b < blocks_ and ordered; ++b) {
+        ordered = offsets_[b] <= offsets_[b + 1];
+    }
+    if (not ordered) {
+        return invalid("damaged block offsets");
+    }
+    return true;
+}
+
+const uint32_t *MeshFile::PlainEdges() const {
+    return Encoding() == MeshEncoding::kPlain and not Faces()
+               ? (const uint32_t *)elements_
+               : nullptr;
+}
+
+const MeshTriangle *MeshFile::PlainTriangles() const {
+    return Encoding() == MeshEncoding::kPlain and Faces()
+               ? (const MeshTriangle *)elements_
+               : nullptr;
+}
+
+bool MeshFile::DecodeBlock(size_t b, IdEdge *out) const {
+    if (Faces() or b >= blocks_) {
+        return false;
+    }
+    Index begin = BlockBegin(b), count = BlockBegin(b + 1) - begin;
+    uint64_t n = header_.point_count;
+    if (Encoding() == MeshEncoding::kPlain) {
+        const uint32_t *e = PlainEdges() + 2 * begin;
+        for (Index i = 0; i < count; ++i) {
+            if (e[2 * i] >= n or e[2 * i + 1] >= n) {
+                return false;
+            }
+            out[i] = {e[2 * i], e[2 * i + 1]};
+        }
+        return true;
+    }
+    const uint8_t *p = elements_ + offsets_[b];
+    const uint8_t *end = elements_ + offsets_[b + 1];
+    uint64_t a = 0;
+    for (Index i = 0; i < count; ++i) {
+        uint64_t da, db;
+        p = GetVarint(p, end, da);
+        p = p != nullptr ? GetVarint(p, end, db) : nullptr;
+        if (p == nullptr or da >= n - a or db >= n - a - da) {
+            return false;
+        }
+        a += da;
+        out[i] = {Index(a), Index(a + db)};
+    }
+    return p == end;
+}
+
+bool MeshFile::DecodeBlock(size_t b, IdTriangle *out) const {
+    if (not Faces() or b >= blocks_) {
+        return false;
+    }
+    Index begin = BlockBegin(b), count = BlockBegin(b + 1) - begin;
+    uint64_t n = header_.point_count;
+    Index size = Size();
+    if (Encoding() == MeshEncoding::kPlain) {
+        const MeshTriangle *records = PlainTriangles() + begin;
+        for (Index i = 0; i < count; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                int32_t neighbor = records[i].neighbors[k];
+                if (records[i].vertices[k] >= n or neighbor < -1 or
+                    neighbor >= size) {
+                    return false;
+                }
+                out[i].vertices[k] = records[i].vertices[k];
+                out[i].neighbors[k] = neighbor;
+            }
+        }
+        return true;
+    }
+    const uint8_t *p = elements_ + offsets_[b];
+    const uint8_t *end = elements_ + offsets_[b + 1];
+    uint64_t a = 0;
+    for (Index i = 0; i < count; ++i) {
+        Index t = begin + i;
+        uint64_t d[6];
+        for (int k = 0; k < 6 and p != nullptr; ++k) {
+            p = GetVarint(p, end, d[k]);
+        }
+        if (p == nullptr or d[0] >= n - a or d[1] >= n - a - d[0] or
+            d[2] >= n - a - d[0]) {
+            return false;
+        }
+        a += d[0];
+        out[i].vertices[0] = a;
+        out[i].vertices[1] = a + d[1];
+        out[i].vertices[2] = a + d[2];
+        for (int k = 0; k < 3; ++k) {
+            int64_t delta = UnZigZag(d[3 + k]);
+            if (d[3 + k] != 0 and (delta < -t or delta >= size - t)) {
+                return false;
+            }
+            out[i].neighbors[k] = d[3 + k] == 0 ? kNoNeighbor : t + delta;
+        }
+    }
+    return p == end;
+}
+
+std::optional<BinaryMesh>
+ReadBinaryMesh(const char *path, int threads, std::string &error) {
+    MeshFile file;
+    if (not file.Open(path, error)) {
+        return {};
+    }
+    BinaryMesh mesh;
+    mesh.faces = file.Faces();
+    mesh.points.assign(file.Points(), file.Points() + file.PointSize());
+    mesh.ids.assign(file.Ids(), file.Ids() + file.PointSize());
+    if (mesh.faces) {
+        mesh.triangles.resize(file.Size());
+    } else {
+        mesh.edges.resize(file.Size());
+    }
+
+    auto workers = MakeWorkers(file.Blocks() > 1 ? threads : 1);
+    std::vector<uint8_t> decoded(file.Blocks());
+    auto decode = [&](size_t b) {
+        Index begin = file.BlockBegin(b);
+        decoded[b] = mesh.faces
+                         ? file.DecodeBlock(b, mesh.triangles.data() + begin)
+                         : file.DecodeBlock(b, mesh.edges.data() + begin);
+    };
+    ForEachIndex(workers.get(), 0, file.Blocks(), 1, decode);
+    auto damaged = std::find(begin(decoded), end(decoded), 0);
+    if (damaged != end(decoded)) {
+        error = std::string(path) + ": block " +
+                std::to_string(damaged - begin(decoded)) + " is damaged";
+        return {};
+    }
+    return mesh;
+}
+
+} // namespace triangulation
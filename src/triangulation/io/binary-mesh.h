@@ -0,0 +1,156 @@
+#pragma once
+
+#include "triangulation/io/point-set.h"
+#include "triangulation/types.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace triangulation {
+
+// Binary mesh files hold the points and either the edges or the triangles
+// of a triangulation, everything little endian:
+//
+//   char     magic[4] = "DTMB"
+//   uint32_t kind          0 for edges, 1 for triangles
+//   uint32_t encoding      a MeshEncoding
+//   uint32_t block_size    elements per block
+//   uint64_t point_count
+//   uint64_t element_count
+//   Point2D  points[point_count]
+//   uint32_t ids[point_count]     the input index of every point
+//   zero padding to 8 bytes, then the elements
+//
+// The points are stored along a Hilbert curve and numbered in that order,
+// so the ends of an edge and the corners of a triangle get close numbers.
+// An edge (a, b) has a < b, and the edges are sorted. A triangle lists its
+// least vertex first and keeps its counter-clockwise turn; the triangles
+// are sorted by that vertex and their neighbors numbered in that order,
+// the one across from vertex k being neighbors[k], -1 on the hull.
+//
+// Plain elements are fixed size records, a uint32_t pair per edge or a
+// MeshTriangle, and a mapped file is read in place. Packed elements come
+// in blocks of block_size that decode on their own, as unsigned LEB128
+// varints:
+// - an edge (a, b) as a - a', then b - a, a' being the a of the edge
+//   before it in the block and 0 for the first one;
+// - a triangle t (a, b, c) as a - a', b - a and c - a, then for each
+//   neighbor n 0 on the hull or else n - t zigzag encoded.
+// The blocks are followed by zero padding to 8 bytes and the uint64_t
+// offsets of every block and of the end of the last one, counted from the
+// first block.
+struct BinaryMeshHeader {
+    char magic[4];
+    uint32_t kind;
+    uint32_t encoding;
+    uint32_t block_size;
+    uint64_t point_count;
+    uint64_t element_count;
+};
+
+static_assert(sizeof(BinaryMeshHeader) == 32);
+
+enum class MeshEncoding : uint32_t { kPlain = 0, kPacked = 1 };
+
+// a triangle as a plain mesh file stores it
+struct MeshTriangle {
+    uint32_t vertices[3];
+    int32_t neighbors[3];
+};
+
+static_assert(sizeof(MeshTriangle) == 24);
+
+// Writers of a mesh file of `pts` and the edges or triangles over them.
+// The blocks are encoded by `threads` threads a batch at a time and the
+// batches written in order, so `f` may be a pipe. They return false when
+// the mesh is too large for 32-bit vertex numbers or the stream reports a
+// write error.
+
+bool WriteBinaryMeshEdges(
+    const PointSet &pts, const std::vector<IdEdge> &edges,
+    MeshEncoding encoding, FILE *f, int threads = 1);
+
+bool WriteBinaryMeshTriangles(
+    const PointSet &pts, const std::vector<IdTriangle> &triangles,
+    MeshEncoding encoding, FILE *f, int threads = 1);
+
+// A mesh file mapped read-only. The points and their input ids are read in
+// place, and so are the elements of a plain file; every block decodes on
+// its own, so blocks can be decoded in parallel or only when needed.
+struct MeshFile {
+  public:
+    MeshFile() = default;
+    ~MeshFile();
+
+    MeshFile(const MeshFile &) = delete;
+    MeshFile &operator=(const MeshFile &) = delete;
+
+    // maps the file and checks that its sections fit
+    bool Open(const char *path, std::string &error);
+
+    // whether the elements are triangles rather than edges
+    bool Faces() const {
+        return header_.kind == 1;
+    }
+    MeshEncoding Encoding() const {
+        return MeshEncoding(header_.encoding);
+    }
+    Index PointSize() const {
+        return header_.point_count;
+    }
+    Index Size() const {
+        return header_.element_count;
+    }
+    size_t Blocks() const {
+        return blocks_;
+    }
+    // block `b` holds the elements [BlockBegin(b), BlockBegin(b + 1))
+    Index BlockBegin(size_t b) const {
+        return std::min<Index>(Index(b) * header_.block_size, Size());
+    }
+
+    const Point2D *Points() const {
+        return points_;
+    }
+    const uint32_t *Ids() const {
+        return ids_;
+    }
+    // the elements of a plain file in place, null in a packed one
+    const uint32_t *PlainEdges() const;
+    const MeshTriangle *PlainTriangles() const;
+
+    // writes the elements of block `b` to `out`; false if the block is
+    // damaged or holds the other kind of element
+    bool DecodeBlock(size_t b, IdEdge *out) const;
+    bool DecodeBlock(size_t b, IdTriangle *out) const;
+
+  private:
+    void *map_ = nullptr;
+    size_t map_size_ = 0;
+    BinaryMeshHeader header_{};
+    size_t blocks_ = 0;
+    const Point2D *points_ = nullptr;
+    const uint32_t *ids_ = nullptr;
+    const uint8_t *elements_ = nullptr;
+    const uint64_t *offsets_ = nullptr;
+};
+
+// a whole mesh file, decoded
+struct BinaryMesh {
+    std::vector<Point2D> points;
+    // the input index of every point
+    std::vector<Index> ids;
+    std::vector<IdEdge> edges;
+    std::vector<IdTriangle> triangles;
+    bool faces = false;
+};
+
+// reads a mesh file, its blocks decoded by `threads` threads
+std::optional<BinaryMesh>
+ReadBinaryMesh(const char *path, int threads, std::string &error);
+
+} // namespace triangulation
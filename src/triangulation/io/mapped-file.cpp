@@ -0,0 +1,44 @@
+#include "triangulation/io/mapped-file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace triangulation {
+
+std::string FileError(const char *what, const char *path) {
+    return std::string(what) + " " + path + ": " + strerror(errno);
+}
+
+void *MapFile(const char *path, size_t &size, std::string &error) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        error = FileError("cannot open", path);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        error = FileError("cannot stat", path);
+        close(fd);
+        return nullptr;
+    }
+    size = st.st_size;
+    if (size == 0) {
+        error = std::string(path) + ": empty file";
+        close(fd);
+        return nullptr;
+    }
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (map == MAP_FAILED) {
+        error = FileError("cannot map", path);
+        return nullptr;
+    }
+    return map;
+}
+
+} // namespace triangulation
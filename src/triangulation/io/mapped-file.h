@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+namespace triangulation {
+
+// "`what` `path`: " followed by the description of errno
+std::string FileError(const char *what, const char *path);
+
+// a private read-only mapping of the whole file, null on failure
+void *MapFile(const char *path, size_t &size, std::string &error);
+
+} // namespace triangulation
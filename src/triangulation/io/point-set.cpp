@@ -0,0 +1,341 @@
+#include "triangulation/io/point-set.h"
+
+#include "triangulation/io/mapped-file.h"
+#include "triangulation/parallel/work-stealing-pool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <utility>
+
+namespace triangulation {
+
+namespace {
+
+constexpr char kBinaryMagic[4] = {'D', 'T', 'P', 'B'};
+
+static_assert(
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+    "binary point files are read in place and assume a little endian host");
+
+static_assert(sizeof(Point2D) == 2 * sizeof(double));
+
+// what is wrong with a header followed by `payload_size` bytes, empty if
+// nothing
+std::string CheckHeader(const BinaryPointHeader &header, size_t payload_size) {
+    if (memcmp(header.magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+        return "not a binary point file";
+    }
+    if (header.dtype != sizeof(double) and header.dtype != sizeof(float)) {
+        return "unsupported dtype " + std::to_string(header.dtype);
+    }
+    if (header.count > payload_size / (2 * header.dtype)) {
+        return std::to_string(header.count) + " points do not fit in the file";
+    }
+    return {};
+}
+
+// text chunks are at least this large, smaller ones do not pay for the
+// task that parses them
+constexpr size_t kMinTextChunk = 1 << 20;
+
+bool IsBlank(char c) {
+    return c == ' ' or c == '\t' or c == '\r';
+}
+
+const char *SkipBlanks(const char *p, const char *end) {
+    while (p < end and IsBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// null when no number starts at `p`; from_chars does not take the leading
+// plus sign scanf accepts
+const char *ParseDouble(const char *p, const char *end, double &value) {
+    if (p < end and *p == '+') {
+        ++p;
+    }
+    auto [next, ec] = std::from_chars(p, end, value);
+    return ec == std::errc() ? next : nullptr;
+}
+
+struct TextChunk {
+    const char *begin, *end;
+    std::vector<Point2D> pts;
+    // the first line that is neither blank nor a point, parsing stops there
+    const char *bad_line = nullptr;
+};
+
+void ParseTextChunk(TextChunk &chunk) {
+    const char *p = chunk.begin, *end = chunk.end;
+    while (p < end) {
+        const char *line = p;
+        p = SkipBlanks(p, end);
+        if (p < end and *p == '\n') {
+            ++p;
+            continue;
+        }
+        double x, y;
+        const char *q = ParseDouble(p, end, x);
+        const char *r = q != nullptr ? SkipBlanks(q, end) : nullptr;
+        q = r != nullptr and r != q ? ParseDouble(r, end, y) : nullptr;
+        q = q != nullptr ? SkipBlanks(q, end) : nullptr;
+        if (q == nullptr or (q < end and *q != '\n')) {
+            chunk.bad_line = line;
+            return;
+        }
+        chunk.pts.emplace_back(x, y);
+        p = q < end ? q + 1 : q;
+    }
+}
+
+std::string LineError(const char *text, const char *line, const char *end) {
+    long long number = 1 + std::count(text, line, '\n');
+    const char *line_end = std::find(line, std::min(end, line + 40), '\n');
+    return "line " + std::to_string(number) + ": expected \"x y\", got \"" +
+           std::string(line, line_end) + "\"";
+}
+
+} // namespace
+
+PointSet::PointSet(std::vector<Point2D> pts)
+    : owned_(std::move(pts)), data_(owned_.data()), size_(owned_.size()) {}
+
+PointSet::~PointSet() {
+    Release();
+}
+
+PointSet::PointSet(PointSet &&other) {
+    *this = std::move(other);
+}
+
+PointSet &PointSet::operator=(PointSet &&other) {
+    if (this != &other) {
+        Release();
+        // moving a vector keeps its buffer, so data_ stays valid
+        owned_ = std::move(other.owned_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        map_ = std::exchange(other.map_, nullptr);
+        map_size_ = std::exchange(other.map_size_, 0);
+    }
+    return *this;
+}
+
+void PointSet::Release() {
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+    owned_.clear();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+std::optional<PointSet> ParseTextPoints(
+    const char *text, const char *end, int threads, std::string &error) {
+    const char *p = text;
+    while (p < end and (IsBlank(*p) or *p == '\n')) {
+        ++p;
+    }
+    long long count = -1;
+    auto [header_end, ec] = std::from_chars(p, end, count);
+    p = SkipBlanks(header_end, end);
+    if (ec != std::errc() or count < 0 or (p < end and *p != '\n')) {
+        error = "line 1: expected the number of points";
+        return {};
+    }
+    const char *body = p < end ? p + 1 : p;
+
+    // chunk boundaries are moved forward to the next line start, so no
+    // line is split; empty chunks are harmless
+    size_t chunk_count = std::max<size_t>(
+        1, std::min<size_t>((end - body) / kMinTextChunk, threads * 8));
+    std::vector<TextChunk> chunks(chunk_count);
+    const char *boundary = body;
+    for (size_t i = 0; i < chunk_count; ++i) {
+        chunks[i].begin = boundary;
+        if (i + 1 == chunk_count) {
+            boundary = end;
+        } else {
+            const char *target = body + (end - body) / chunk_count * (i + 1);
+            boundary = std::max(boundary, target);
+            const char *eol =
+                (const char *)memchr(boundary, '\n', end - boundary);
+            boundary = eol != nullptr ? eol + 1 : end;
+        }
+        chunks[i].end = boundary;
+    }
+
+    auto workers = MakeWorkers(chunk_count > 1 ? threads : 1);
+    ForEachIndex(workers.get(), 0, chunk_count, 1, [&](size_t i) {
+        ParseTextChunk(chunks[i]);
+    });
+
+    // only the first `count` points are read, as scanf did, so whatever
+    // follows them does not matter
+    std::vector<long long> offsets(chunk_count, count);
+    long long parsed = 0;
+    for (size_t i = 0; i < chunk_count and parsed < count; ++i) {
+        offsets[i] = parsed;
+        parsed += chunks[i].pts.size();
+        if (chunks[i].bad_line != nullptr and parsed < count) {
+            error = LineError(text, chunks[i].bad_line, end);
+            return {};
+        }
+    }
+    if (parsed < count) {
+        error = "expected " + std::to_string(count) + " points, found " +
+                std::to_string(parsed);
+        return {};
+    }
+
+    std::vector<Point2D> pts(count);
+    ForEachIndex(workers.get(), 0, chunk_count, 1, [&](size_t i) {
+        long long n =
+            std::min<long long>(chunks[i].pts.size(), count - offsets[i]);
+        std::copy_n(chunks[i].pts.begin(), n, pts.begin() + offsets[i]);
+        chunks[i].pts = {};
+    });
+    return PointSet(std::move(pts));
+}
+
+std::optional<PointSet> MapBinaryPoints(const char *path, std::string &error) {
+    size_t file_size;
+    void *map = MapFile(path, file_size, error);
+    if (map == nullptr) {
+        return {};
+    }
+    if (file_size < sizeof(BinaryPointHeader)) {
+        error = std::string(path) + ": truncated header";
+        munmap(map, file_size);
+        return {};
+    }
+
+    BinaryPointHeader header;
+    memcpy(&header, map, sizeof(header));
+    const char *payload = (const char *)map + sizeof(header);
+    size_t payload_size = file_size - sizeof(header);
+    std::string invalid = CheckHeader(header, payload_size);
+    if (not invalid.empty()) {
+        error = std::string(path) + ": " + invalid;
+        munmap(map, file_size);
+        return {};
+    }
+    // the points are read once from front to back
+    madvise(map, file_size, MADV_SEQUENTIAL);
+
+    PointSet result;
+    if (header.dtype == sizeof(double)) {
+        result.map_ = map;
+        result.map_size_ = file_size;
+        result.data_ = (const Point2D *)payload;
+        result.size_ = header.count;
+        return result;
+    }
+    std::vector<Point2D> pts(header.count);
+    const float *coords = (const float *)payload;
+    for (size_t i = 0; i < header.count; ++i) {
+        pts[i] = Point2D(coords[2 * i], coords[2 * i + 1]);
+    }
+    munmap(map, file_size);
+    return PointSet(std::move(pts));
+}
+
+std::optional<PointSet> ReadPointFile(
+    const char *path, PointFormat format, int threads, std::string &error) {
+    if (format == PointFormat::kBinary) {
+        return MapBinaryPoints(path, error);
+    }
+    size_t size;
+    void *map = MapFile(path, size, error);
+    if (map == nullptr) {
+        return {};
+    }
+    // chunks are parsed out of order
+    madvise(map, size, MADV_WILLNEED);
+    const char *text = (const char *)map;
+    auto result = ParseTextPoints(text, text + size, threads, error);
+    munmap(map, size);
+    if (not result) {
+        error = std::string(path) + ": " + error;
+    }
+    return result;
+}
+
+bool WriteBinaryPoints(const PointSet &pts, const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    BinaryPointHeader header;
+    memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    header.dtype = sizeof(double);
+    header.count = pts.Size();
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 and
+              fwrite(pts.Data(), sizeof(Point2D), pts.Size(), f) ==
+                  (size_t)pts.Size();
+    return fclose(f) == 0 and ok;
+}
+
+BinaryPointReader::~BinaryPointReader() {
+    if (file_ != nullptr) {
+        fclose(file_);
+    }
+}
+
+bool BinaryPointReader::Open(const char *path, std::string &error) {
+    file_ = fopen(path, "rb");
+    if (file_ == nullptr) {
+        error = FileError("cannot open", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fileno(file_), &st) == -1) {
+        error = FileError("cannot stat", path);
+        return false;
+    }
+    if (fread(&header_, sizeof(header_), 1, file_) != 1) {
+        error = std::string(path) + ": truncated header";
+        return false;
+    }
+    std::string invalid = CheckHeader(header_, st.st_size - sizeof(header_));
+    if (not invalid.empty()) {
+        error = std::string(path) + ": " + invalid;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryPointReader::Read(std::vector<Point2D> &block, size_t max) {
+    size_t count = std::min<uint64_t>(max, header_.count - read_);
+    block.resize(count);
+    if (header_.dtype == sizeof(double)) {
+        if (fread(block.data(), sizeof(Point2D), count, file_) != count) {
+            return false;
+        }
+    } else {
+        floats_.resize(2 * count);
+        if (fread(floats_.data(), sizeof(float), 2 * count, file_) !=
+            2 * count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            block[i] = Point2D(floats_[2 * i], floats_[2 * i + 1]);
+        }
+    }
+    read_ += count;
+    return true;
+}
+
+bool BinaryPointReader::Rewind() {
+    read_ = 0;
+    return fseek(file_, sizeof(header_), SEEK_SET) == 0;
+}
+
+} // namespace triangulation
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <optional>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace triangulation {
+
+// Binary point files hold a 16 byte header followed by the packed
+// coordinates x0 y0 x1 y1 ..., everything little endian:
+//
+//   char     magic[4] = "DTPB"
+//   uint32_t dtype       bytes per coordinate, 8 for double, 4 for float
+//   uint64_t count       number of points
+//
+// The header keeps the coordinates 16 byte aligned in a mapped file, so
+// doubles can be read in place as Point2D.
+struct BinaryPointHeader {
+    char magic[4];
+    uint32_t dtype;
+    uint64_t count;
+};
+
+static_assert(sizeof(BinaryPointHeader) == 16);
+
+enum class PointFormat { kText, kBinary };
+
+// A read-only sequence of points, either owned or mapped from a binary
+// point file of doubles
+struct PointSet {
+  public:
+    PointSet() = default;
+    PointSet(std::vector<Point2D> pts);
+    ~PointSet();
+
+    PointSet(PointSet &&other);
+    PointSet &operator=(PointSet &&other);
+
+    const Point2D *Data() const {
+        return data_;
+    }
+    Index Size() const {
+        return size_;
+    }
+    const Point2D &operator[](Index i) const {
+        return data_[i];
+    }
+
+    // whether the points are read straight from a file mapping
+    bool Mapped() const {
+        return map_ != nullptr;
+    }
+
+  private:
+    void Release();
+
+    std::vector<Point2D> owned_;
+    const Point2D *data_ = nullptr;
+    Index size_ = 0;
+    void *map_ = nullptr;
+    size_t map_size_ = 0;
+
+    friend std::optional<PointSet>
+    MapBinaryPoints(const char *path, std::string &error);
+};
+
+// the text format: the number of points, then one "x y" pair per line;
+// blank lines are skipped and anything after the last point is ignored.
+// The text is split into chunks at line starts, which `threads` threads
+// parse with from_chars.
+std::optional<PointSet> ParseTextPoints(
+    const char *text, const char *end, int threads, std::string &error);
+
+// maps a binary point file, float files are widened into owned doubles
+std::optional<PointSet> MapBinaryPoints(const char *path, std::string &error);
+
+std::optional<PointSet> ReadPointFile(
+    const char *path, PointFormat format, int threads, std::string &error);
+
+bool WriteBinaryPoints(const PointSet &pts, const char *path);
+
+// Reads a binary point file from front to back a block at a time, for
+// inputs too large to hold in memory
+struct BinaryPointReader {
+  public:
+    BinaryPointReader() = default;
+    ~BinaryPointReader();
+
+    BinaryPointReader(const BinaryPointReader &) = delete;
+    BinaryPointReader &operator=(const BinaryPointReader &) = delete;
+
+    bool Open(const char *path, std::string &error);
+
+    Index Size() const {
+        return header_.count;
+    }
+
+    // the next at most `max` points, `block` is left empty at the end;
+    // false on a read error
+    bool Read(std::vector<Point2D> &block, size_t max);
+
+    // starts over from the first point
+    bool Rewind();
+
+  private:
+    FILE *file_ = nullptr;
+    BinaryPointHeader header_{};
+    uint64_t read_ = 0;
+    std::vector<float> floats_;
+};
+
+} // namespace triangulation
@@ -0,0 +1,166 @@
+#include "triangulation/io/text-output.h"
+
+#include "triangulation/parallel/work-stealing-pool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <memory>
+
+namespace triangulation {
+
+namespace {
+
+// lines formatted by one task into one buffer
+constexpr size_t kLinesPerBlock = 1 << 16;
+
+// the longest "%.3f" of a double, 309 integer digits, sign, point and
+// decimals, with room to spare
+constexpr size_t kMaxNumberLength = 320;
+
+// room to keep free in a buffer before formatting one more line
+constexpr size_t kMaxLineLength = 2 * kMaxNumberLength + 2;
+
+struct Buffer {
+    std::vector<char> data;
+    size_t used = 0;
+
+    char *Reserve(size_t length) {
+        if (data.size() - used < length) {
+            data.resize(std::max(data.size() * 2, used + length));
+        }
+        return data.data() + used;
+    }
+};
+
+char *FormatFixed3(char *out, double value) {
+    return std::to_chars(
+               out, out + kMaxNumberLength, value, std::chars_format::fixed,
+               3)
+        .ptr;
+}
+
+char *FormatInt(char *out, Index value) {
+    return std::to_chars(out, out + kMaxNumberLength, value).ptr;
+}
+
+// formats `count` lines with `format(i, out)`, which writes line i at
+// `out` and returns its end, a batch of blocks at a time: the blocks of a
+// batch are formatted concurrently and then written in order. No line is
+// longer than `max_line`.
+template <typename Format>
+bool WriteLines(
+    size_t count, FILE *f, int threads, const Format &format,
+    size_t max_line = kMaxLineLength) {
+    size_t blocks = (count + kLinesPerBlock - 1) / kLinesPerBlock;
+    auto workers = MakeWorkers(blocks > 1 ? threads : 1);
+    size_t batch = workers ? 2 * workers->Size() : 1;
+    std::vector<Buffer> buffers(batch);
+    auto format_block = [&](size_t block, Buffer &buffer) {
+        size_t begin = block * kLinesPerBlock;
+        size_t end = std::min(count, begin + kLinesPerBlock);
+        buffer.used = 0;
+        for (size_t i = begin; i < end; ++i) {
+            buffer.used =
+                format(i, buffer.Reserve(max_line)) - buffer.data.data();
+        }
+    };
+    for (size_t first = 0; first < blocks; first += batch) {
+        size_t last = std::min(blocks, first + batch);
+        ForEachIndex(workers.get(), first, last, 1, [&](size_t block) {
+            format_block(block, buffers[block - first]);
+        });
+        for (size_t block = first; block < last; ++block) {
+            const Buffer &buffer = buffers[block - first];
+            if (fwrite(buffer.data.data(), 1, buffer.used, f) != buffer.used) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool WritePointsText(const PointSet &pts, FILE *f, int threads) {
+    return WritePointCountText(pts.Size(), f) and
+           WritePointLinesText(pts.Data(), pts.Size(), f, threads);
+}
+
+bool WritePointCountText(Index count, FILE *f) {
+    return fprintf(f, "%lld\n", (long long)count) >= 0;
+}
+
+bool WritePointLinesText(
+    const Point2D *pts, size_t count, FILE *f, int threads) {
+    return WriteLines(count, f, threads, [pts](size_t i, char *out) {
+        out = FormatFixed3(out, pts[i](0));
+        *out++ = ' ';
+        out = FormatFixed3(out, pts[i](1));
+        *out++ = '\n';
+        return out;
+    });
+}
+
+bool WriteEdgesText(const std::vector<IdEdge> &edges, FILE *f, int threads) {
+    return WriteLines(edges.size(), f, threads, [&edges](size_t i, char *out) {
+        out = FormatInt(out, edges[i].p1);
+        *out++ = ' ';
+        out = FormatInt(out, edges[i].p2);
+        *out++ = '\n';
+        return out;
+    });
+}
+
+bool WriteTrianglesText(
+    const std::vector<IdTriangle> &triangles, FILE *f, int threads) {
+    return WriteLines(
+        triangles.size(), f, threads, [&triangles](size_t i, char *out) {
+            const IdTriangle &t = triangles[i];
+            for (Index v : t.vertices) {
+                out = FormatInt(out, v);
+                *out++ = ' ';
+            }
+            for (int k = 0; k < 3; ++k) {
+                out = FormatInt(out, t.neighbors[k]);
+                *out++ = k < 2 ? ' ' : '\n';
+            }
+            return out;
+        });
+}
+
+bool WriteTriangleVerticesText(
+    const std::vector<IdTriangle> &triangles, FILE *f, int threads) {
+    return WriteLines(
+        triangles.size(), f, threads, [&triangles](size_t i, char *out) {
+            const IdTriangle &t = triangles[i];
+            for (int k = 0; k < 3; ++k) {
+                out = FormatInt(out, t.vertices[k]);
+                *out++ = k < 2 ? ' ' : '\n';
+            }
+            return out;
+        });
+}
+
+bool WriteVoronoiText(const VoronoiDiagram &diagram, FILE *f, int threads) {
+    Index most = 0;
+    for (Index i = 0; i < diagram.Size(); ++i) {
+        most = std::max(most, diagram.offsets[i + 1] - diagram.offsets[i]);
+    }
+    return WriteLines(
+        diagram.Size(), f, threads,
+        [&diagram](size_t i, char *out) {
+            Index begin = diagram.offsets[i], end = diagram.offsets[i + 1];
+            out = FormatInt(out, end - begin);
+            for (Index c = begin; c < end; ++c) {
+                *out++ = ' ';
+                out = FormatFixed3(out, diagram.corners[c](0));
+                *out++ = ' ';
+                out = FormatFixed3(out, diagram.corners[c](1));
+            }
+            *out++ = '\n';
+            return out;
+        },
+        (2 * most + 1) * (kMaxNumberLength + 1) + 1);
+}
+
+} // namespace triangulation
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "triangulation/io/point-set.h"
+#include "triangulation/types.h"
+#include "triangulation/voronoi.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace triangulation {
+
+// Writers for the text output format: the number of points, one "x y"
+// line per point with three decimals, then either one "i j" line per edge
+// or one "a b c n0 n1 n2" line per triangle: its counter-clockwise
+// vertices and the triangles across from them, -1 on the hull.
+//
+// Blocks of lines are formatted with to_chars into reused buffers, by
+// `threads` threads at a time, and every buffer goes out in one fwrite.
+// They return false when the stream reports a write error.
+
+bool WritePointsText(const PointSet &pts, FILE *f, int threads = 1);
+
+// WritePointsText in parts, for points streamed a block at a time: the
+// count first, then the lines of every block
+bool WritePointCountText(Index count, FILE *f);
+
+bool WritePointLinesText(
+    const Point2D *pts, size_t count, FILE *f, int threads = 1);
+
+bool WriteEdgesText(const std::vector<IdEdge> &edges, FILE *f, int threads = 1);
+
+bool WriteTrianglesText(
+    const std::vector<IdTriangle> &triangles, FILE *f, int threads = 1);
+
+// one "a b c" line per triangle, leaving out the neighbors
+bool WriteTriangleVerticesText(
+    const std::vector<IdTriangle> &triangles, FILE *f, int threads = 1);
+
+// one "k x1 y1 ... xk yk" line per cell, its k counter-clockwise corners
+bool WriteVoronoiText(
+    const VoronoiDiagram &diagram, FILE *f, int threads = 1);
+
+} // namespace triangulation
@@ -1,9 +1,22 @@
 #include "triangulation/algorithms/divide-and-conquer/triangulate.h"
+#include "triangulation/algorithms/incremental/triangulate.h"
+#include "triangulation/algorithms/sweep-hull/triangulate.h"
 #include "triangulation/algorithms/interface.h"
+#include "triangulation/algorithms/out-of-core/triangulate.h"
+#include "triangulation/coordinate-traits.h"
+#include "triangulation/io/binary-mesh.h"
+#include "triangulation/io/point-set.h"
+#include "triangulation/io/text-output.h"
+#include "triangulation/point-distributions.h"
+#include "triangulation/stats.h"
 #include "triangulation/types.h"
 #include "triangulation/utility.h"
+#include "triangulation/verify.h"
+#include "triangulation/voronoi.h"
 
 #include <chrono>
+#include <memory>
+#include <optional>
 #include <random>
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,153 +27,538 @@ using namespace triangulation;
 using namespace std::string_view_literals;
 namespace chrono = std::chrono;
 
-void LogPoints(const std::vector<Point2D> &pts) {
+void LogPoints(const PointSet &pts [[maybe_unused]]) {
 #ifndef NDEBUG
     LOGLN("---- Logging input points start -----");
-    fprintf(stderr, "%d\n", (int)pts.size());
-    for (int i = 0; i < pts.size(); ++i) {
+    fprintf(stderr, "%d\n", (int)pts.Size());
+    for (Index i = 0; i < pts.Size(); ++i) {
         fprintf(stderr, "%.3f %.3f\n", pts[i](0), pts[i](1));
     }
     LOGLN("----- Logging input points end -----");
 #endif
 }
 
-void WritePointsToStream(const std::vector<Point2D> &pts, FILE *f) {
-    fprintf(f, "%d\n", (int)pts.size());
-    for (int i = 0; i < pts.size(); ++i) {
-        fprintf(f, "%.3f %.3f\n", pts[i](0), pts[i](1));
-    }
-}
+// either the edges or the triangles of the triangulation, or the Voronoi
+// cells built from the triangles
+struct Result {
+    std::vector<IdEdge> edges;
+    std::vector<IdTriangle> triangles;
+    VoronoiDiagram cells;
+    bool faces = false;
+    bool voronoi = false;
+    // written as a binary mesh file of this encoding rather than as text
+    std::optional<MeshEncoding> mesh;
+};
 
-void WriteEdgesToStream(const std::vector<IdEdge> &edges, FILE *f) {
-    for (int i = 0; i < edges.size(); ++i) {
-        fprintf(f, "%d %d\n", (int)edges[i].p1, (int)edges[i].p2);
+bool WriteResultToStream(
+    const PointSet &pts, const Result &result, FILE *f, int threads = 1) {
+    if (result.mesh and result.faces) {
+        return WriteBinaryMeshTriangles(
+            pts, result.triangles, *result.mesh, f, threads);
     }
+    if (result.mesh) {
+        return WriteBinaryMeshEdges(
+            pts, result.edges, *result.mesh, f, threads);
+    }
+    if (not WritePointsText(pts, f, threads)) {
+        return false;
+    }
+    if (result.voronoi) {
+        return WriteVoronoiText(result.cells, f, threads);
+    }
+    if (result.faces) {
+        return WriteTrianglesText(result.triangles, f, threads);
+    }
+    return WriteEdgesText(result.edges, f, threads);
 }
 
-void WriteResultToStream(
-    const std::vector<Point2D> &pts, const std::vector<IdEdge> &edges,
-    FILE *f) {
-    WritePointsToStream(pts, f);
-    WriteEdgesToStream(edges, f);
-}
-
-void PrintResult(
-    const std::vector<Point2D> &pts, const std::vector<IdEdge> &edges) {
-    WriteResultToStream(pts, edges, stdin);
+void PrintResult(const PointSet &pts, const Result &result) {
+    WriteResultToStream(pts, result, stdout);
 }
 
 void WriteResultToFile(
-    const std::vector<Point2D> &pts, const std::vector<IdEdge> &edges,
-    const char *path) {
+    const PointSet &pts, const Result &result, const char *path) {
     FILE *f = fopen(path, "w");
-    WriteResultToStream(pts, edges, f);
+    WriteResultToStream(pts, result, f);
     fclose(f);
 }
 
-std::vector<Point2D> RandomPoints(int n, int max = -1) {
-    if (max == -1) {
-        max = n * 5;
-    }
-    std::vector<Point2D> points;
-    points.reserve(n);
-    std::mt19937 gen(std::random_device{}());
-    std::uniform_real_distribution<double> dis(0, max);
-    for (int i = 0; i < n; ++i) {
-        points.emplace_back(dis(gen), dis(gen));
-    }
-    return points;
-}
-
-chrono::microseconds RunTriangulation(
-    const Triangulator &algo, const std::vector<Point2D> &pts, FILE *output) {
-    auto inputs = TagPointWithIndex(pts);
+Result RunTriangulation(
+    const Triangulator &algo, const PointSet &pts, bool faces,
+    chrono::microseconds &running_time) {
+    Result result;
+    result.faces = faces;
+    auto inputs = TagPointWithIndex(pts.Data(), pts.Size());
     auto start_time = chrono::system_clock::now();
-    auto edges = algo.Triangulate(std::move(inputs));
+    if (faces) {
+        result.triangles = algo.TriangulateFaces(std::move(inputs));
+    } else {
+        result.edges = algo.Triangulate(std::move(inputs));
+    }
     auto end_time = chrono::system_clock::now();
-    WriteResultToStream(pts, edges, output);
-    return end_time - start_time;
+    running_time =
+        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+    return result;
 }
 
-std::vector<Point2D> ReadPoints(FILE *f) {
-    std::vector<Point2D> pts;
-    int num;
-    fscanf(f, "%d", &num);
-    pts.reserve(num);
-    for (int i = 0; i < num; ++i) {
-        double x, y;
-        auto err = fscanf(f, "%lf %lf", &x, &y);
-        assert(err != -1);
-        pts.emplace_back(x, y);
-    }
-    return pts;
+// every edge of the triangles once, from the triangle with the lower id
+std::vector<IdEdge> EdgesOf(const std::vector<IdTriangle> &triangles) {
+    std::vector<IdEdge> edges;
+    for (Index t = 0; t < Index(triangles.size()); ++t) {
+        const IdTriangle &tri = triangles[t];
+        for (int k = 0; k < 3; ++k) {
+            if (tri.neighbors[k] == kNoNeighbor or tri.neighbors[k] > t) {
+                Index a = tri.vertices[(k + 1) % 3];
+                Index b = tri.vertices[(k + 2) % 3];
+                edges.push_back(a < b ? IdEdge{a, b} : IdEdge{b, a});
+            }
+        }
+    }
+    return edges;
 }
 
-std::vector<Point2D> ReadPointsFromFile(const char *path) {
-    auto f = fopen(path, "r");
-    auto result = ReadPoints(f);
-    fclose(f);
-    return result;
+// the box around the points grown by a tenth of its size on every side
+BoundingBox DefaultVoronoiBox(const PointSet &pts) {
+    if (pts.Size() == 0) {
+        return BoundingBox{Point2D::Zero(), Point2D::Zero()};
+    }
+    Point2D lo = pts[0], hi = pts[0];
+    for (Index i = 1; i < pts.Size(); ++i) {
+        lo = lo.cwiseMin(pts[i]);
+        hi = hi.cwiseMax(pts[i]);
+    }
+    Point2D margin = (hi - lo) / 10;
+    return BoundingBox{lo - margin, hi + margin};
 }
 
 constexpr const char *kHelpMessage =
     "usage: triangulation "
     "[-r | --random] [-n <int>] [-i | --input file] [-o | --output file]\n"
+    "[--distribution name] [--seed <int>] [--input-format text|binary]\n"
+    "[--save-points file] [--output-format edges|triangles|voronoi]\n"
+    "[--output-encoding text|packed|plain]\n"
+    "[--voronoi-box x0 y0 x1 y1] [--no-output] [--verify]\n"
+    "[--stats file] [--threads <int>] [--algorithm name]\n"
+    "[--tile-points <int>] [--temp-dir dir]\n"
     "\n"
     "-r | --random\n\tRandomly generate point data\n"
     "-n <int> = 50\n\tThe number of points, "
     "only valid when --random is specified\n"
+    "--distribution name = uniform\n\tDistribution of the random points: "
+    "uniform, clusters, grid,\n\tcircle, strips or duplicates\n"
+    "--seed <int>\n\tSeed of the random points, a fresh one by default\n"
     "-o | --out   file\n\tOutput file path\n"
+    "--output-format edges|triangles|voronoi = edges\n"
+    "\tWrite the edges, the triangles with their neighbors, or the\n"
+    "\tVoronoi cells of the points\n"
+    "--output-encoding text|packed|plain = text\n"
+    "\tWrite the edges or the triangles as text, or as a binary mesh file\n"
+    "\tof delta and varint coded blocks or of fixed size records\n"
+    "--voronoi-box x0 y0 x1 y1\n"
+    "\tThe box Voronoi cells are clipped to, by default the box around\n"
+    "\tthe points grown by a tenth of its size on every side\n"
+    "--no-output\n\tSkip writing the result, to time the algorithm alone\n"
+    "--verify\n\tCheck that the triangles are a Delaunay triangulation of\n"
+    "\tthe points, report what is wrong and exit with 1 if anything is\n"
     "-i | --input file\n\tInput point file path, overrides --random and -n\n"
-    "-t | --time\n\tPrint algorithm execution time\n"
+    "--input-format text|binary = text\n\tFormat of the input point file\n"
+    "--save-points file\n\tWrite the input points as a binary point file\n"
+    "--stats file\n\tWrite phase times, counters and merge depths as JSON, "
+    "\"-\" for stderr\n"
+    "-t | --time\n\tPrint algorithm execution and output time\n"
+    "--threads <int> = 1\n"
+    "\tNumber of threads used to parse, triangulate and write\n"
+    "--algorithm name = divide-and-conquer\n"
+    "\tdivide-and-conquer: Guibas-Stolfi divide and conquer\n"
+    "\talternating-cuts: divide and conquer alternating vertical and\n"
+    "\t\thorizontal cuts, faster on evenly spread points\n"
+    "\tfloat-coordinates: divide and conquer over float coordinates\n"
+    "\tint32-coordinates: divide and conquer over integer coordinates\n"
+    "\t\twithin 2^29, with exact integer predicates\n"
+    "\t\tBoth round the points to their coordinates first\n"
+    "\tincremental: randomized incremental insertion\n"
+    "\tsweep-hull: left to right sweep, flipping as it goes\n"
+    "--tile-points <int>\n"
+    "\tTriangulate out of core, in vertical strips of about this many\n"
+    "\tpoints; needs a binary input file and writes one\n"
+    "\t<a : int> <b : int> <c : int> line per triangle, without neighbors\n"
+    "--temp-dir dir = /tmp\n\tWhere the strips go when out of core\n"
     "\nInput file format:\n"
     "<number-of-points : int>\n"
     "<x1 : double> <y1 : double>\n"
     "<x2 : double> <y2 : double>\n"
-    "...\n";
+    "...\n"
+    "\nOutput file format:\n"
+    "<the input points, as above>\n"
+    "<i : int> <j : int>\n\tOne line per edge, or with triangles:\n"
+    "<a : int> <b : int> <c : int> <na : int> <nb : int> <nc : int>\n"
+    "\tOne line per counter-clockwise triangle, na being the index of the\n"
+    "\ttriangle across the edge opposite a, -1 on the convex hull\n"
+    "\tor with Voronoi cells, one line per point:\n"
+    "<k : int> <x1 : double> <y1 : double> ... <xk : double> <yk : double>\n"
+    "\tThe k counter-clockwise corners of its cell\n"
+    "\nBinary point file format, little endian:\n"
+    "<magic : \"DTPB\"> <dtype : uint32, 8 for double or 4 for float>\n"
+    "<number-of-points : uint64>\n"
+    "<x1> <y1> <x2> <y2> ... packed as dtype\n"
+    "\nBinary mesh file format, little endian:\n"
+    "<magic : \"DTMB\"> <kind : uint32, 0 for edges or 1 for triangles>\n"
+    "<encoding : uint32, 0 plain or 1 packed> <block-size : uint32>\n"
+    "<number-of-points : uint64> <number-of-elements : uint64>\n"
+    "<the points as doubles> <their input indices as uint32>\n"
+    "\tThe points in Hilbert curve order, followed by the elements as\n"
+    "\tsrc/triangulation/io/binary-mesh.h describes\n";
 
 int main(int argc, char *argv[]) {
-    bool random = true;
+    bool random [[maybe_unused]] = true;
     int n = 20;
+    Distribution distribution = Distribution::kUniform;
+    uint32_t seed = std::random_device{}();
     const char *inpath = nullptr;
     FILE *out_stream = stdout;
-    std::vector<Point2D> points;
-    std::unique_ptr<Triangulator> algo = std::make_unique<DivideAndConquer>();
+    bool output = true;
+    bool verify = false;
+    bool faces = false;
+    bool voronoi = false;
+    std::optional<MeshEncoding> mesh_encoding;
+    std::optional<BoundingBox> voronoi_box;
+    PointFormat input_format = PointFormat::kText;
+    const char *save_points = nullptr;
+    PointSet points;
+    int threads = 1;
+    const char *algorithm = "divide-and-conquer";
     bool time = false;
+    const char *stats_path = nullptr;
+    OutOfCoreOptions out_of_core;
+    bool tiled = false;
 
     for (int i = 1; i < argc; ++i) {
         const char *arg = argv[i];
         if (arg == "-i"sv or arg == "--input"sv) {
             inpath = argv[++i];
+        } else if (arg == "--input-format"sv) {
+            const char *format = argv[++i];
+            if (format == "text"sv) {
+                input_format = PointFormat::kText;
+            } else if (format == "binary"sv) {
+                input_format = PointFormat::kBinary;
+            } else {
+                fprintf(
+                    stderr, "%s: unknown input format: %s\n", argv[0],
+                    format);
+                exit(1);
+            }
+        } else if (arg == "--save-points"sv) {
+            save_points = argv[++i];
         } else if (arg == "-r"sv or arg == "--random"sv) {
             random = true;
         } else if (arg == "-n"sv) {
             n = atoi(argv[++i]);
+        } else if (arg == "--distribution"sv) {
+            const char *name = argv[++i];
+            if (not ParseDistribution(name, distribution)) {
+                fprintf(
+                    stderr, "%s: unknown distribution: %s\n", argv[0], name);
+                exit(1);
+            }
+        } else if (arg == "--seed"sv) {
+            seed = strtoul(argv[++i], nullptr, 10);
         } else if (arg == "-o"sv or arg == "--out"sv) {
-            out_stream = fopen(argv[++i], "w");
+            const char *outpath = argv[++i];
+            out_stream = fopen(outpath, "w");
+            if (out_stream == nullptr) {
+                fprintf(stderr, "%s: cannot open %s\n", argv[0], outpath);
+                exit(1);
+            }
+        } else if (arg == "--stats"sv) {
+            stats_path = argv[++i];
+            if (not TRIANGULATION_STATS) {
+                fprintf(
+                    stderr, "%s: built without TRIANGULATION_STATS\n",
+                    argv[0]);
+                exit(1);
+            }
+            stats::SetEnabled(true);
+        } else if (arg == "--output-format"sv) {
+            const char *format = argv[++i];
+            if (format == "edges"sv or format == "triangles"sv or
+                format == "voronoi"sv) {
+                faces = format != "edges"sv;
+                voronoi = format == "voronoi"sv;
+            } else {
+                fprintf(
+                    stderr, "%s: unknown output format: %s\n", argv[0],
+                    format);
+                exit(1);
+            }
+        } else if (arg == "--output-encoding"sv) {
+            const char *encoding = argv[++i];
+            if (encoding == "text"sv) {
+                mesh_encoding.reset();
+            } else if (encoding == "packed"sv) {
+                mesh_encoding = MeshEncoding::kPacked;
+            } else if (encoding == "plain"sv) {
+                mesh_encoding = MeshEncoding::kPlain;
+            } else {
+                fprintf(
+                    stderr, "%s: unknown output encoding: %s\n", argv[0],
+                    encoding);
+                exit(1);
+            }
+        } else if (arg == "--voronoi-box"sv) {
+            if (i + 4 >= argc) {
+                fprintf(
+                    stderr, "%s: --voronoi-box needs four numbers\n",
+                    argv[0]);
+                exit(1);
+            }
+            double x0 = atof(argv[++i]), y0 = atof(argv[++i]);
+            double x1 = atof(argv[++i]), y1 = atof(argv[++i]);
+            voronoi_box = BoundingBox{Point2D(x0, y0), Point2D(x1, y1)};
+        } else if (arg == "--no-output"sv) {
+            output = false;
+        } else if (arg == "--verify"sv) {
+            verify = true;
         } else if (arg == "-h"sv or arg == "--help"sv) {
             printf("%s", kHelpMessage);
             exit(0);
         } else if (arg == "-t"sv or arg == "--time"sv) {
             time = true;
+        } else if (arg == "--threads"sv) {
+            threads = atoi(argv[++i]);
+        } else if (arg == "--algorithm"sv) {
+            algorithm = argv[++i];
+        } else if (arg == "--tile-points"sv) {
+            out_of_core.tile_points = atoll(argv[++i]);
+            tiled = true;
+        } else if (arg == "--temp-dir"sv) {
+            out_of_core.temp_dir = argv[++i];
         } else {
             fprintf(stderr, "%s: invalid option: %s\n", argv[0], argv[i]);
             exit(1);
         }
     }
 
+    if (mesh_encoding and voronoi) {
+        fprintf(
+            stderr, "%s: Voronoi cells are only written as text\n", argv[0]);
+        exit(1);
+    }
+
+    if (tiled) {
+        if (inpath == nullptr or input_format != PointFormat::kBinary or
+            out_of_core.tile_points < 1) {
+            fprintf(
+                stderr,
+                "%s: --tile-points needs a positive count and a binary input "
+                "file\n",
+                argv[0]);
+            exit(1);
+        }
+        if (verify or mesh_encoding) {
+            fprintf(
+                stderr,
+                "%s: --verify and binary meshes need the triangles in "
+                "memory\n",
+                argv[0]);
+            exit(1);
+        }
+        out_of_core.threads = threads;
+        OutOfCoreStats tiled_stats;
+        std::string error;
+        auto start_time = chrono::system_clock::now();
+        if (not TriangulateOutOfCore(
+                inpath, output ? out_stream : nullptr, out_of_core,
+                tiled_stats, error) or
+            (output and fflush(out_stream) != 0)) {
+            fprintf(
+                stderr, "%s: %s\n", argv[0],
+                error.empty() ? "cannot write the result" : error.c_str());
+            exit(1);
+        }
+        auto running_time = chrono::duration_cast<chrono::microseconds>(
+            chrono::system_clock::now() - start_time);
+        if (time) {
+            fprintf(
+                stderr,
+                "Out-of-core Time: %.2f ms, %lld tiles, at most %lld points "
+                "at once\n",
+                running_time.count() / 1000., (long long)tiled_stats.tiles,
+                (long long)tiled_stats.peak_points);
+        }
+        return 0;
+    }
+
+    std::unique_ptr<Triangulator> algo;
+    // how the algorithm rounds the coordinates, if it does, so that
+    // --verify checks the points it triangulates
+    double (*round)(double) = nullptr;
+    if (algorithm == "divide-and-conquer"sv) {
+        algo = std::make_unique<DivideAndConquer>(threads);
+    } else if (algorithm == "alternating-cuts"sv) {
+        algo = std::make_unique<DivideAndConquer>(
+            threads, DivideAndConquer::Cuts::kAlternating);
+    } else if (algorithm == "float-coordinates"sv) {
+        algo = std::make_unique<DivideAndConquer>(
+            threads, DivideAndConquer::Cuts::kVertical,
+            DivideAndConquer::Coordinates::kFloat);
+        round = CoordinateTraits<float>::Round;
+    } else if (algorithm == "int32-coordinates"sv) {
+        algo = std::make_unique<DivideAndConquer>(
+            threads, DivideAndConquer::Cuts::kVertical,
+            DivideAndConquer::Coordinates::kInt32);
+        round = CoordinateTraits<int32_t>::Round;
+    } else if (algorithm == "incremental"sv) {
+        algo = std::make_unique<Incremental>();
+    } else if (algorithm == "sweep-hull"sv) {
+        algo = std::make_unique<SweepHull>();
+    } else {
+        fprintf(stderr, "%s: unknown algorithm: %s\n", argv[0], algorithm);
+        exit(1);
+    }
+
     if (inpath != nullptr) {
-        points = ReadPointsFromFile(inpath);
+        std::string error;
+        auto loaded = ReadPointFile(inpath, input_format, threads, error);
+        if (not loaded) {
+            fprintf(stderr, "%s: %s\n", argv[0], error.c_str());
+            exit(1);
+        }
+        points = std::move(*loaded);
     } else {
-        points = RandomPoints(n);
+        points = GeneratePoints(distribution, n, seed);
+    }
+
+    if (points.Size() > algo->MaxPoints()) {
+        fprintf(
+            stderr, "%s: %lld points, %s takes at most %lld\n", argv[0],
+            (long long)points.Size(), algorithm, (long long)algo->MaxPoints());
+        exit(1);
+    }
+
+    if (round == CoordinateTraits<int32_t>::Round) {
+        for (Index i = 0; i < points.Size(); ++i) {
+            const Point2D &p = points.Data()[i];
+            if (not CoordinateTraits<int32_t>::Fits(p(0)) or
+                not CoordinateTraits<int32_t>::Fits(p(1))) {
+                fprintf(
+                    stderr,
+                    "%s: point %lld (%g, %g) is out of the int32-coordinates "
+                    "range, |x| and |y| up to 2^29\n",
+                    argv[0], (long long)i, p(0), p(1));
+                exit(1);
+            }
+        }
+    }
+
+    if (save_points != nullptr and not WriteBinaryPoints(points, save_points)) {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], save_points);
+        exit(1);
     }
 
     LogPoints(points);
 
-    auto running_time = RunTriangulation(*algo, points, out_stream);
+    chrono::microseconds running_time;
+    stats::Reset();
+    auto result =
+        RunTriangulation(*algo, points, faces or verify, running_time);
+    if (stats_path != nullptr) {
+        FILE *f = stats_path == "-"sv ? stderr : fopen(stats_path, "w");
+        if (f == nullptr) {
+            fprintf(stderr, "%s: cannot open %s\n", argv[0], stats_path);
+            exit(1);
+        }
+        stats::WriteJson(stats::Total(), f);
+        if (f != stderr) {
+            fclose(f);
+        }
+    }
     if (time) {
         fprintf(
             stderr, "Algorithm Execution Time: %.2f ms\n",
             running_time.count() / 1000.);
     }
-}
\ No newline at end of file
+    result.mesh = mesh_encoding;
+    bool valid = true;
+    if (verify) {
+        auto start_time = chrono::system_clock::now();
+        const Point2D *triangulated = points.Data();
+        std::vector<Point2D> rounded;
+        if (round != nullptr) {
+            rounded.assign(points.Data(), points.Data() + points.Size());
+            for (auto &p : rounded) {
+                p = Point2D(round(p(0)), round(p(1)));
+            }
+            triangulated = rounded.data();
+        }
+        auto report = VerifyDelaunay(
+            triangulated, points.Size(), result.triangles, threads);
+        auto verify_time = chrono::duration_cast<chrono::microseconds>(
+            chrono::system_clock::now() - start_time);
+        if (time) {
+            fprintf(
+                stderr, "Verification Time: %.2f ms\n",
+                verify_time.count() / 1000.);
+        }
+        valid = report.Valid();
+        if (not valid) {
+            fprintf(
+                stderr,
+                "%s: not a Delaunay triangulation: %lld bad triangles, %lld "
+                "bad neighbors, %lld bad fans, %lld missing points, %lld "
+                "non-Delaunay edges%s%s\n",
+                argv[0], report.bad_triangles, report.bad_neighbors,
+                report.bad_fans, report.missing_points,
+                report.non_delaunay_edges,
+                report.hull_mismatch ? ", wrong hull" : "",
+                report.euler_mismatch ? ", wrong Euler characteristic" : "");
+            for (const auto &message : report.messages) {
+                fprintf(stderr, "\t%s\n", message.c_str());
+            }
+        }
+        if (not faces) {
+            // the edges were asked for, and triangles are none when the
+            // points are all on a line
+            result.faces = false;
+            if (result.triangles.empty()) {
+                result.edges = algo->Triangulate(
+                    TagPointWithIndex(points.Data(), points.Size()));
+            } else {
+                result.edges = EdgesOf(result.triangles);
+            }
+        }
+    }
+    if (voronoi) {
+        auto start_time = chrono::system_clock::now();
+        result.voronoi = true;
+        result.cells = ComputeVoronoi(
+            points.Data(), points.Size(), result.triangles,
+            voronoi_box.value_or(DefaultVoronoiBox(points)), threads);
+        auto voronoi_time = chrono::duration_cast<chrono::microseconds>(
+            chrono::system_clock::now() - start_time);
+        if (time) {
+            fprintf(
+                stderr, "Voronoi Time: %.2f ms\n",
+                voronoi_time.count() / 1000.);
+        }
+    }
+
+    if (output) {
+        auto start_time = chrono::system_clock::now();
+        if (not WriteResultToStream(points, result, out_stream, threads) or
+            fflush(out_stream) != 0) {
+            fprintf(stderr, "%s: cannot write the result\n", argv[0]);
+            exit(1);
+        }
+        auto output_time = chrono::duration_cast<chrono::microseconds>(
+            chrono::system_clock::now() - start_time);
+        if (time) {
+            fprintf(
+                stderr, "Output Time: %.2f ms\n",
+                output_time.count() / 1000.);
+        }
+    }
+    if (not valid) {
+        exit(1);
+    }
+}
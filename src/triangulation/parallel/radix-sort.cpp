@@ -0,0 +1,87 @@
+#include "triangulation/parallel/radix-sort.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace triangulation {
+
+namespace {
+
+constexpr int kDigitBits = 16;
+constexpr size_t kBuckets = size_t(1) << kDigitBits;
+constexpr int kPasses = (64 + kDigitBits - 1) / kDigitBits;
+
+// a chunk should outweigh its own table of counts
+constexpr size_t kMinChunk = 1 << 17;
+
+uint32_t Digit(uint64_t key, int pass) {
+    return (key >> (pass * kDigitBits)) & (kBuckets - 1);
+}
+
+} // namespace
+
+void RadixSort(
+    std::vector<RadixItem> &items, std::vector<RadixItem> &buffer,
+    WorkStealingPool *workers) {
+    size_t n = items.size();
+    assert(n < (uint64_t(1) << 32));
+    buffer.resize(n);
+    size_t chunks = 1;
+    if (workers != nullptr) {
+        chunks = std::max<size_t>(
+            1, std::min<size_t>(workers->Size(), n / kMinChunk));
+    }
+    auto chunk_begin = [&](size_t c) { return n * c / chunks; };
+
+    std::vector<uint64_t> all_ones(chunks, ~uint64_t(0)), any_ones(chunks, 0);
+    ForEachIndex(workers, 0, chunks, 1, [&](size_t c) {
+        uint64_t all = ~uint64_t(0), any = 0;
+        for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+            all &= items[i].key;
+            any |= items[i].key;
+        }
+        all_ones[c] = all;
+        any_ones[c] = any;
+    });
+    uint64_t all = ~uint64_t(0), any = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        all &= all_ones[c];
+        any |= any_ones[c];
+    }
+    // the bits set in some keys but not in all of them
+    uint64_t varying = any & ~all;
+
+    // counts[c * kBuckets + d] becomes the position the next item of chunk
+    // c with digit d goes to
+    std::vector<uint32_t> counts(chunks * kBuckets);
+    for (int pass = 0; pass < kPasses; ++pass) {
+        if (Digit(varying, pass) == 0) {
+            continue;
+        }
+        ForEachIndex(workers, 0, chunks, 1, [&](size_t c) {
+            uint32_t *count = &counts[c * kBuckets];
+            std::fill(count, count + kBuckets, 0);
+            for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+                ++count[Digit(items[i].key, pass)];
+            }
+        });
+        // bucket-major, chunk-minor order keeps equal digits in input order
+        uint32_t position = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            for (size_t c = 0; c < chunks; ++c) {
+                uint32_t count = counts[c * kBuckets + d];
+                counts[c * kBuckets + d] = position;
+                position += count;
+            }
+        }
+        ForEachIndex(workers, 0, chunks, 1, [&](size_t c) {
+            uint32_t *next = &counts[c * kBuckets];
+            for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+                buffer[next[Digit(items[i].key, pass)]++] = items[i];
+            }
+        });
+        items.swap(buffer);
+    }
+}
+
+} // namespace triangulation
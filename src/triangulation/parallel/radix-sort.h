@@ -0,0 +1,34 @@
+#pragma once
+
+#include "triangulation/parallel/work-stealing-pool.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace triangulation {
+
+// an unsigned integer ordered like the double `x`: a < b exactly when
+// OrderedBits(a) < OrderedBits(b), NaN aside; -0 and +0 give the same key
+inline uint64_t OrderedBits(double x) {
+    x += 0.0;
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    // negative numbers count down from the sign bit, positive ones up
+    return bits >> 63 ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+struct RadixItem {
+    uint64_t key;
+    uint32_t index;
+};
+
+// Stable least-significant-digit radix sort of `items` by key, using
+// `buffer` as scratch space. Every pass counts the digits of its chunk of
+// the input on one worker and scatters the chunks in order, so `workers`
+// may be null for a sequential sort. Digits all keys agree on are skipped.
+void RadixSort(
+    std::vector<RadixItem> &items, std::vector<RadixItem> &buffer,
+    WorkStealingPool *workers);
+
+} // namespace triangulation
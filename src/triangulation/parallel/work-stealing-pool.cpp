@@ -0,0 +1,116 @@
+#include "triangulation/parallel/work-stealing-pool.h"
+
+#include <assert.h>
+
+namespace triangulation {
+
+namespace {
+
+thread_local const WorkStealingPool *current_pool = nullptr;
+thread_local int current_index = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 1; i < threads; ++i) {
+        threads_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto &t : threads_) {
+        t.join();
+    }
+}
+
+int WorkStealingPool::WorkerIndex() const {
+    return current_pool == this ? current_index : 0;
+}
+
+void WorkStealingPool::Spawn(Task &task) {
+    Worker &self = *workers_[WorkerIndex()];
+    {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        self.tasks.push_back(&task);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        ++queued_;
+    }
+    sleep_cv_.notify_one();
+}
+
+void WorkStealingPool::Wait(Task &task) {
+    int index = WorkerIndex();
+    while (not task.done.load(std::memory_order_acquire)) {
+        if (Task *other = FindTask(index)) {
+            Execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkStealingPool::WorkerLoop(int index) {
+    current_pool = this;
+    current_index = index;
+    for (;;) {
+        if (Task *task = FindTask(index)) {
+            Execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] { return stop_ or queued_ > 0; });
+        if (stop_) {
+            return;
+        }
+    }
+}
+
+WorkStealingPool::Task *WorkStealingPool::FindTask(int index) {
+    int n = workers_.size();
+    for (int k = 0; k < n; ++k) {
+        Worker &w = *workers_[(index + k) % n];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.tasks.empty()) {
+            continue;
+        }
+        Task *task;
+        if (k == 0) {
+            task = w.tasks.back();
+            w.tasks.pop_back();
+        } else {
+            task = w.tasks.front();
+            w.tasks.pop_front();
+        }
+        --queued_;
+        return task;
+    }
+    return nullptr;
+}
+
+void WorkStealingPool::Execute(Task *task) {
+    assert(not task->done);
+    task->run();
+    task->done.store(true, std::memory_order_release);
+}
+
+std::unique_ptr<WorkStealingPool> MakeWorkers(int threads) {
+    if (threads > 1) {
+        return std::make_unique<WorkStealingPool>(threads);
+    }
+    return nullptr;
+}
+
+} // namespace triangulation
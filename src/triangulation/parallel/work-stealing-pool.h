@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace triangulation {
+
+// Fork-join thread pool where every worker owns a deque of tasks. A worker
+// runs its newest task first and steals the oldest task of another worker
+// when it runs dry, and a thread waiting on a task keeps running other
+// tasks in the meantime. The thread that creates the pool is worker 0.
+struct WorkStealingPool {
+  public:
+    struct Task {
+        std::function<void()> run;
+        std::atomic<bool> done{false};
+    };
+
+    WorkStealingPool(int threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int Size() const {
+        return workers_.size();
+    }
+
+    // the index of the calling thread in this pool, 0 for any thread that
+    // is not one of its workers
+    int WorkerIndex() const;
+
+    // makes `task` available to the pool, it must outlive the Wait on it
+    void Spawn(Task &task);
+
+    void Wait(Task &task);
+
+    // runs `f` on the calling thread while `g` may be stolen by another
+    // worker, returns once both finished
+    template <typename F, typename G>
+    void Invoke(F &&f, G &&g) {
+        Task task;
+        task.run = std::forward<G>(g);
+        Spawn(task);
+        f();
+        Wait(task);
+    }
+
+    // runs `f(i)` for every i in [begin, end), halving the range until
+    // the pieces are at most `grain` long
+    template <typename F>
+    void ParallelFor(size_t begin, size_t end, size_t grain, const F &f) {
+        if (end - begin <= grain or end - begin < 2) {
+            for (size_t i = begin; i < end; ++i) {
+                f(i);
+            }
+            return;
+        }
+        size_t mid = begin + (end - begin) / 2;
+        Invoke(
+            [&] { ParallelFor(begin, mid, grain, f); },
+            [&] { ParallelFor(mid, end, grain, f); });
+    }
+
+  private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task *> tasks;
+    };
+
+    void WorkerLoop(int index);
+    Task *FindTask(int index);
+    static void Execute(Task *task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<int> queued_{0};
+    bool stop_ = false;
+};
+
+// a pool of `threads` workers, or none for a single thread, in which case
+// the helpers below run everything on the calling thread
+std::unique_ptr<WorkStealingPool> MakeWorkers(int threads);
+
+// ParallelFor on `workers`, or a plain loop when there are none
+template <typename F>
+void ForEachIndex(
+    WorkStealingPool *workers, size_t begin, size_t end, size_t grain,
+    const F &f) {
+    if (workers == nullptr) {
+        for (size_t i = begin; i < end; ++i) {
+            f(i);
+        }
+        return;
+    }
+    workers->ParallelFor(begin, end, grain, f);
+}
+
+// runs `f(begin, end)` on the blocks of `block` indices that cover
+// [0, count), a block per task
+template <typename F>
+void ForEachBlock(
+    WorkStealingPool *workers, size_t count, size_t block, const F &f) {
+    size_t blocks = (count + block - 1) / block;
+    ForEachIndex(workers, 0, blocks, 1, [&](size_t b) {
+        f(b * block, std::min(count, (b + 1) * block));
+    });
+}
+
+} // namespace triangulation
@@ -0,0 +1,117 @@
+#include "triangulation/point-distributions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string.h>
+
+namespace triangulation {
+
+namespace {
+
+constexpr int kStripCount = 8;
+
+constexpr int kCopiesPerDuplicate = 4;
+
+} // namespace
+
+const char *DistributionName(Distribution d) {
+    switch (d) {
+    case Distribution::kUniform:
+        return "uniform";
+    case Distribution::kClusters:
+        return "clusters";
+    case Distribution::kGrid:
+        return "grid";
+    case Distribution::kCircle:
+        return "circle";
+    case Distribution::kStrips:
+        return "strips";
+    case Distribution::kDuplicates:
+        return "duplicates";
+    }
+    return "unknown";
+}
+
+bool ParseDistribution(const char *name, Distribution &d) {
+    for (Distribution candidate : kAllDistributions) {
+        if (strcmp(name, DistributionName(candidate)) == 0) {
+            d = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Point2D> GeneratePoints(Distribution d, Index n, uint32_t seed) {
+    std::mt19937_64 gen(seed);
+    double extent = std::max<double>(n, 1) * 5;
+    std::uniform_real_distribution<double> coord(0, extent);
+    std::vector<Point2D> pts;
+    pts.reserve(n);
+
+    switch (d) {
+    case Distribution::kUniform:
+        for (Index i = 0; i < n; ++i) {
+            pts.emplace_back(coord(gen), coord(gen));
+        }
+        break;
+    case Distribution::kClusters: {
+        // about a thousand points per cluster
+        Index clusters = std::max<Index>(1, n / 1000);
+        std::vector<Point2D> centers;
+        for (Index i = 0; i < clusters; ++i) {
+            centers.emplace_back(coord(gen), coord(gen));
+        }
+        std::uniform_int_distribution<Index> pick(0, clusters - 1);
+        std::normal_distribution<double> offset(
+            0, extent / std::sqrt((double)clusters) / 20);
+        for (Index i = 0; i < n; ++i) {
+            const Point2D &c = centers[pick(gen)];
+            pts.emplace_back(c(0) + offset(gen), c(1) + offset(gen));
+        }
+        break;
+    }
+    case Distribution::kGrid: {
+        Index side = std::ceil(std::sqrt((double)n));
+        double spacing = extent / std::max<Index>(side, 1);
+        for (Index i = 0; i < n; ++i) {
+            pts.emplace_back(i % side * spacing, i / side * spacing);
+        }
+        break;
+    }
+    case Distribution::kCircle: {
+        std::uniform_real_distribution<double> angle(0, 2 * M_PI);
+        double r = extent / 2;
+        for (Index i = 0; i < n; ++i) {
+            double a = angle(gen);
+            pts.emplace_back(r + r * std::cos(a), r + r * std::sin(a));
+        }
+        break;
+    }
+    case Distribution::kStrips: {
+        std::uniform_int_distribution<int> strip(0, kStripCount - 1);
+        std::uniform_real_distribution<double> noise(-1e-9, 1e-9);
+        for (Index i = 0; i < n; ++i) {
+            double y = (strip(gen) + 0.5) * extent / kStripCount;
+            pts.emplace_back(coord(gen), y * (1 + noise(gen)));
+        }
+        break;
+    }
+    case Distribution::kDuplicates: {
+        Index distinct =
+            std::min<Index>(n, std::max<Index>(1, n / kCopiesPerDuplicate));
+        for (Index i = 0; i < distinct; ++i) {
+            pts.emplace_back(coord(gen), coord(gen));
+        }
+        for (Index i = distinct; i < n; ++i) {
+            pts.push_back(pts[i % distinct]);
+        }
+        std::shuffle(begin(pts), end(pts), gen);
+        break;
+    }
+    }
+    return pts;
+}
+
+} // namespace triangulation
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+// Seeded point generators for testing and benchmarking. Every distribution
+// spreads its points over about [0, 5n) on both axes, like the random
+// input of the command line tool, and the same (n, seed) always yields
+// the same points.
+enum class Distribution {
+    // independent uniform coordinates
+    kUniform,
+    // normal clusters around uniform centers, dense and empty regions
+    kClusters,
+    // an integer lattice, full of collinear and cocircular points
+    kGrid,
+    // points on a circle, every point on the hull and all nearly cocircular
+    kCircle,
+    // a few horizontal lines perturbed by far less than the point spacing
+    kStrips,
+    // a quarter as many distinct uniform points, each repeated four times
+    kDuplicates,
+};
+
+constexpr Distribution kAllDistributions[] = {
+    Distribution::kUniform, Distribution::kClusters, Distribution::kGrid,
+    Distribution::kCircle,  Distribution::kStrips,   Distribution::kDuplicates,
+};
+
+const char *DistributionName(Distribution d);
+
+// false if `name` names no distribution
+bool ParseDistribution(const char *name, Distribution &d);
+
+std::vector<Point2D> GeneratePoints(Distribution d, Index n, uint32_t seed);
+
+} // namespace triangulation
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+// Points in structure-of-arrays layout, addressed by a dense 32-bit vertex
+// number: x[v] and y[v] are its coordinates and id[v] its input index.
+// That is 24 bytes a point against the 32 of a PointRef, 16 with float or
+// int32 coordinates, and code walking vertices in order reads each
+// coordinate array sequentially. Coordinates are converted to T as they
+// come in, so inputs for a narrower T must already be representable in it.
+template <typename T>
+struct BasicPointStore {
+  public:
+    using Vertex = uint32_t;
+    static constexpr Vertex kNoVertex = ~Vertex(0);
+
+    BasicPointStore() = default;
+
+    // the points in the order given, `pts` can be released afterwards
+    explicit BasicPointStore(const std::vector<PointRef> &pts) {
+        assert(pts.size() < kNoVertex);
+        x_.reserve(pts.size());
+        y_.reserve(pts.size());
+        id_.reserve(pts.size());
+        for (const auto &p : pts) {
+            x_.push_back(T(p.X()));
+            y_.push_back(T(p.Y()));
+            id_.push_back(p.id);
+        }
+    }
+
+    // vertex v is the point pts[order[v]]
+    BasicPointStore(
+        const std::vector<PointRef> &pts, const std::vector<Vertex> &order) {
+        Assign(pts, order);
+    }
+
+    // replaces the points as the constructor above would, keeping the
+    // capacity of the arrays
+    void Assign(
+        const std::vector<PointRef> &pts, const std::vector<Vertex> &order) {
+        assert(order.size() < kNoVertex);
+        x_.resize(order.size());
+        y_.resize(order.size());
+        id_.resize(order.size());
+        for (size_t v = 0; v < order.size(); ++v) {
+            const PointRef &p = pts[order[v]];
+            x_[v] = T(p.X());
+            y_[v] = T(p.Y());
+            id_[v] = p.id;
+        }
+    }
+
+    Index Size() const {
+        return x_.size();
+    }
+
+    T X(Vertex v) const {
+        return x_[v];
+    }
+    T Y(Vertex v) const {
+        return y_[v];
+    }
+    Point2D Point(Vertex v) const {
+        return Point2D(double(x_[v]), double(y_[v]));
+    }
+    Index Id(Vertex v) const {
+        return id_[v];
+    }
+
+  private:
+    std::vector<T> x_, y_;
+    std::vector<Index> id_;
+};
+
+using PointStore = BasicPointStore<double>;
+
+} // namespace triangulation
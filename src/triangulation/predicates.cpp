@@ -0,0 +1,244 @@
+#include "triangulation/predicates.h"
+
+#include <assert.h>
+#include <atomic>
+
+namespace triangulation::predicates {
+
+namespace {
+
+// Expansion arithmetic after Shewchuk, "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates". An expansion is an
+// array of non-overlapping doubles sorted by increasing magnitude whose sum
+// is the exact value, so its sign is the sign of the last component.
+
+constexpr double kSplitter = 134217729.0; // 2^27 + 1
+
+// the largest expansion built on the way to an exact in-circle determinant
+constexpr int kMaxProductSize = 512;
+
+std::atomic<long long> orientation_fallbacks{0};
+std::atomic<long long> in_circle_fallbacks{0};
+
+void FastTwoSum(double a, double b, double &x, double &y) {
+    x = a + b;
+    double b_virtual = x - a;
+    y = b - b_virtual;
+}
+
+void TwoSum(double a, double b, double &x, double &y) {
+    x = a + b;
+    double b_virtual = x - a;
+    double a_virtual = x - b_virtual;
+    double b_round = b - b_virtual;
+    double a_round = a - a_virtual;
+    y = a_round + b_round;
+}
+
+void TwoDiff(double a, double b, double &x, double &y) {
+    x = a - b;
+    double b_virtual = a - x;
+    double a_virtual = x + b_virtual;
+    double b_round = b_virtual - b;
+    double a_round = a - a_virtual;
+    y = a_round + b_round;
+}
+
+void Split(double a, double &hi, double &lo) {
+    double c = kSplitter * a;
+    double a_big = c - a;
+    hi = c - a_big;
+    lo = a - hi;
+}
+
+void TwoProductPresplit(
+    double a, double b, double b_hi, double b_lo, double &x, double &y) {
+    x = a * b;
+    double a_hi, a_lo;
+    Split(a, a_hi, a_lo);
+    double err1 = x - (a_hi * b_hi);
+    double err2 = err1 - (a_lo * b_hi);
+    double err3 = err2 - (a_hi * b_lo);
+    y = (a_lo * b_lo) - err3;
+}
+
+// h = a - b as an expansion of one or two components
+int Difference(double a, double b, double *h) {
+    double x, y;
+    TwoDiff(a, b, x, y);
+    if (y == 0) {
+        h[0] = x;
+        return 1;
+    }
+    h[0] = y;
+    h[1] = x;
+    return 2;
+}
+
+// h = e + f, h has room for elen + flen components
+int Sum(int elen, const double *e, int flen, const double *f, double *h) {
+    int ei = 0, fi = 0, hi = 0;
+    double e_now = e[0], f_now = f[0];
+    auto next_e = [&] { e_now = ++ei < elen ? e[ei] : 0; };
+    auto next_f = [&] { f_now = ++fi < flen ? f[fi] : 0; };
+    double q, q_new, hh;
+    if ((f_now > e_now) == (f_now > -e_now)) {
+        q = e_now;
+        next_e();
+    } else {
+        q = f_now;
+        next_f();
+    }
+    if (ei < elen and fi < flen) {
+        if ((f_now > e_now) == (f_now > -e_now)) {
+            FastTwoSum(e_now, q, q_new, hh);
+            next_e();
+        } else {
+            FastTwoSum(f_now, q, q_new, hh);
+            next_f();
+        }
+        q = q_new;
+        if (hh != 0) h[hi++] = hh;
+        while (ei < elen and fi < flen) {
+            if ((f_now > e_now) == (f_now > -e_now)) {
+                TwoSum(q, e_now, q_new, hh);
+                next_e();
+            } else {
+                TwoSum(q, f_now, q_new, hh);
+                next_f();
+            }
+            q = q_new;
+            if (hh != 0) h[hi++] = hh;
+        }
+    }
+    while (ei < elen) {
+        TwoSum(q, e_now, q_new, hh);
+        next_e();
+        q = q_new;
+        if (hh != 0) h[hi++] = hh;
+    }
+    while (fi < flen) {
+        TwoSum(q, f_now, q_new, hh);
+        next_f();
+        q = q_new;
+        if (hh != 0) h[hi++] = hh;
+    }
+    if (q != 0 or hi == 0) h[hi++] = q;
+    return hi;
+}
+
+// h = e * b, h has room for 2 * elen components
+int Scale(int elen, const double *e, double b, double *h) {
+    double b_hi, b_lo;
+    Split(b, b_hi, b_lo);
+    double q, hh, product1, product0, sum;
+    TwoProductPresplit(e[0], b, b_hi, b_lo, q, hh);
+    int hi = 0;
+    if (hh != 0) h[hi++] = hh;
+    for (int ei = 1; ei < elen; ++ei) {
+        TwoProductPresplit(e[ei], b, b_hi, b_lo, product1, product0);
+        TwoSum(q, product0, sum, hh);
+        if (hh != 0) h[hi++] = hh;
+        FastTwoSum(product1, sum, q, hh);
+        if (hh != 0) h[hi++] = hh;
+    }
+    if (q != 0 or hi == 0) h[hi++] = q;
+    return hi;
+}
+
+// h = e * f, h has room for 2 * elen * flen components
+int Product(int elen, const double *e, int flen, const double *f, double *h) {
+    assert(2 * elen * flen <= kMaxProductSize);
+    double scaled[kMaxProductSize], acc[kMaxProductSize];
+    int len = Scale(elen, e, f[0], h);
+    for (int i = 1; i < flen; ++i) {
+        int slen = Scale(elen, e, f[i], scaled);
+        for (int k = 0; k < len; ++k) {
+            acc[k] = h[k];
+        }
+        len = Sum(len, acc, slen, scaled, h);
+    }
+    return len;
+}
+
+void Negate(int elen, double *e) {
+    for (int i = 0; i < elen; ++i) {
+        e[i] = -e[i];
+    }
+}
+
+// h = p * q - r * s for expansions of at most two components
+int CrossDifference(
+    const double *p, int plen, const double *q, int qlen, const double *r,
+    int rlen, const double *s, int slen, double *h) {
+    double left[8], right[8];
+    int llen = Product(plen, p, qlen, q, left);
+    int rlen2 = Product(rlen, r, slen, s, right);
+    Negate(rlen2, right);
+    return Sum(llen, left, rlen2, right, h);
+}
+
+// h = lift * cross where lift = x * x + y * y
+int LiftedTerm(
+    const double *x, int xlen, const double *y, int ylen,
+    const double *cross, int clen, double *h) {
+    double xx[8], yy[8], lift[16];
+    int xxlen = Product(xlen, x, xlen, x, xx);
+    int yylen = Product(ylen, y, ylen, y, yy);
+    int llen = Sum(xxlen, xx, yylen, yy, lift);
+    return Product(llen, lift, clen, cross, h);
+}
+
+} // namespace
+
+double OrientationExact(
+    double ax, double ay, double bx, double by, double cx, double cy) {
+    orientation_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    double acx[2], bcy[2], acy[2], bcx[2], det[16];
+    int acx_len = Difference(ax, cx, acx), bcy_len = Difference(by, cy, bcy),
+        acy_len = Difference(ay, cy, acy), bcx_len = Difference(bx, cx, bcx);
+    int len = CrossDifference(
+        acx, acx_len, bcy, bcy_len, acy, acy_len, bcx, bcx_len, det);
+    return det[len - 1];
+}
+
+double InCircleExact(
+    double ax, double ay, double bx, double by, double cx, double cy,
+    double dx, double dy) {
+    in_circle_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+    int adx_len = Difference(ax, dx, adx), ady_len = Difference(ay, dy, ady),
+        bdx_len = Difference(bx, dx, bdx), bdy_len = Difference(by, dy, bdy),
+        cdx_len = Difference(cx, dx, cdx), cdy_len = Difference(cy, dy, cdy);
+
+    double bc[16], ca[16], ab[16];
+    int bc_len = CrossDifference(
+        bdx, bdx_len, cdy, cdy_len, cdx, cdx_len, bdy, bdy_len, bc);
+    int ca_len = CrossDifference(
+        cdx, cdx_len, ady, ady_len, adx, adx_len, cdy, cdy_len, ca);
+    int ab_len = CrossDifference(
+        adx, adx_len, bdy, bdy_len, bdx, bdx_len, ady, ady_len, ab);
+
+    double a_term[kMaxProductSize], b_term[kMaxProductSize],
+        c_term[kMaxProductSize];
+    int a_len = LiftedTerm(adx, adx_len, ady, ady_len, bc, bc_len, a_term);
+    int b_len = LiftedTerm(bdx, bdx_len, bdy, bdy_len, ca, ca_len, b_term);
+    int c_len = LiftedTerm(cdx, cdx_len, cdy, cdy_len, ab, ab_len, c_term);
+
+    double ab_sum[2 * kMaxProductSize], det[3 * kMaxProductSize];
+    int ab_sum_len = Sum(a_len, a_term, b_len, b_term, ab_sum);
+    int len = Sum(ab_sum_len, ab_sum, c_len, c_term, det);
+    return det[len - 1];
+}
+
+FallbackCount ExactFallbacks() {
+    return FallbackCount{orientation_fallbacks.load(),
+                         in_circle_fallbacks.load()};
+}
+
+void ResetExactFallbacks() {
+    orientation_fallbacks = 0;
+    in_circle_fallbacks = 0;
+}
+
+} // namespace triangulation::predicates
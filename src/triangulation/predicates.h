@@ -0,0 +1,88 @@
+#pragma once
+
+#include "triangulation/stats.h"
+#include "triangulation/types.h"
+
+#include <cmath>
+
+namespace triangulation {
+
+// Geometric predicates with an exact sign, in the style of Shewchuk's
+// adaptive predicates: the determinant is first evaluated in plain floating
+// point and only recomputed with exact expansion arithmetic when it does not
+// clear a static error bound.
+
+namespace predicates {
+
+constexpr double kEpsilon = 0x1p-53;
+constexpr double kOrientationErrorBound = (3.0 + 16.0 * kEpsilon) * kEpsilon;
+constexpr double kInCircleErrorBound = (10.0 + 96.0 * kEpsilon) * kEpsilon;
+
+double OrientationExact(
+    double ax, double ay, double bx, double by, double cx, double cy);
+
+double InCircleExact(
+    double ax, double ay, double bx, double by, double cx, double cy,
+    double dx, double dy);
+
+// how many times the floating-point filter failed and the exact
+// computation ran, counted over all threads
+struct FallbackCount {
+    long long orientation;
+    long long in_circle;
+};
+
+FallbackCount ExactFallbacks();
+
+void ResetExactFallbacks();
+
+} // namespace predicates
+
+// positive when a, b, c are counter-clockwise, negative when clockwise and
+// zero when collinear; only the sign is exact
+inline double
+OrientationDeterminant(const Point2D &a, const Point2D &b, const Point2D &c) {
+    STATS_COUNT(kOrientationCalls);
+    double ax = a(0), ay = a(1), bx = b(0), by = b(1), cx = c(0), cy = c(1);
+    double det_left = (ax - cx) * (by - cy);
+    double det_right = (ay - cy) * (bx - cx);
+    double det = det_left - det_right;
+    // a single well predicted branch, the sign of det is close to random
+    double bound = predicates::kOrientationErrorBound *
+                   (std::abs(det_left) + std::abs(det_right));
+    if (std::abs(det) >= bound) {
+        return det;
+    }
+    return predicates::OrientationExact(ax, ay, bx, by, cx, cy);
+}
+
+// positive when d lies inside the circle through the counter-clockwise
+// a, b, c, negative outside and zero on it; only the sign is exact
+inline double InCircleDeterminant(
+    const Point2D &a, const Point2D &b, const Point2D &c, const Point2D &d) {
+    STATS_COUNT(kInCircleCalls);
+    double adx = a(0) - d(0), ady = a(1) - d(1);
+    double bdx = b(0) - d(0), bdy = b(1) - d(1);
+    double cdx = c(0) - d(0), cdy = c(1) - d(1);
+
+    double bdx_cdy = bdx * cdy, cdx_bdy = cdx * bdy;
+    double cdx_ady = cdx * ady, adx_cdy = adx * cdy;
+    double adx_bdy = adx * bdy, bdx_ady = bdx * ady;
+    double a_lift = adx * adx + ady * ady;
+    double b_lift = bdx * bdx + bdy * bdy;
+    double c_lift = cdx * cdx + cdy * cdy;
+
+    double det = a_lift * (bdx_cdy - cdx_bdy) + b_lift * (cdx_ady - adx_cdy) +
+                 c_lift * (adx_bdy - bdx_ady);
+    double permanent = (std::abs(bdx_cdy) + std::abs(cdx_bdy)) * a_lift +
+                       (std::abs(cdx_ady) + std::abs(adx_cdy)) * b_lift +
+                       (std::abs(adx_bdy) + std::abs(bdx_ady)) * c_lift;
+    double bound = predicates::kInCircleErrorBound * permanent;
+    if (std::abs(det) > bound) {
+        return det;
+    }
+    return predicates::InCircleExact(
+        a(0), a(1), b(0), b(1), c(0), c(1), d(0), d(1));
+}
+
+} // namespace triangulation
@@ -0,0 +1,282 @@
+#include "triangulation/query/point-locator.h"
+
+#include "triangulation/parallel/radix-sort.h"
+#include "triangulation/parallel/work-stealing-pool.h"
+#include "triangulation/predicates.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <memory>
+#include <stdint.h>
+
+namespace triangulation {
+
+namespace {
+
+constexpr uint32_t kEmptyCell = ~uint32_t(0);
+
+// queries answered by one task of a batch
+constexpr size_t kQueriesPerTask = 1 << 12;
+
+double SquaredDistance(const Point2D &a, const Point2D &b) {
+    return (a - b).squaredNorm();
+}
+
+// the cell coordinate of `offset` cells, clamped to [0, size), NaN to 0
+int ClampCell(double offset, int size) {
+    if (not(offset >= 0)) {
+        return 0;
+    }
+    return offset < size ? int(offset) : size - 1;
+}
+
+// the bits of `x` moved to the even positions
+uint64_t Spread(uint32_t x) {
+    uint64_t r = x;
+    r = (r | r << 16) & 0x0000ffff0000ffff;
+    r = (r | r << 8) & 0x00ff00ff00ff00ff;
+    r = (r | r << 4) & 0x0f0f0f0f0f0f0f0f;
+    r = (r | r << 2) & 0x3333333333333333;
+    r = (r | r << 1) & 0x5555555555555555;
+    return r;
+}
+
+} // namespace
+
+PointLocator::PointLocator(
+    const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles)
+    : points_(pts, pts + n), vertex_ids_(n), offsets_(n + 1) {
+    assert(n < Index(kEmptyCell) and triangles.size() < size_t(INT32_MAX));
+    for (Index v = 0; v < n; ++v) {
+        vertex_ids_[v] = v;
+    }
+    if (triangles.empty()) {
+        return;
+    }
+
+    Point2D lo = points_[0], hi = points_[0];
+    for (const auto &p : points_) {
+        lo = lo.cwiseMin(p);
+        hi = hi.cwiseMax(p);
+    }
+    double width = hi(0) - lo(0), height = hi(1) - lo(1);
+    double cells = std::max<double>(1, triangles.size() / 2);
+    double cell = std::sqrt(width * height / cells);
+    origin_ = lo;
+    inverse_cell_ = 1 / cell;
+    columns_ = std::clamp<double>(std::ceil(width / cell), 1, cells);
+    rows_ = std::clamp<double>(std::ceil(height / cell), 1, cells);
+    cells_.assign(size_t(columns_) * rows_, kEmptyCell);
+
+    // the vertices and the triangles are renumbered in Z-order over the
+    // grid, so a walk mostly touches memory close to where it started
+    std::vector<RadixItem> items(n), buffer;
+    for (Index v = 0; v < n; ++v) {
+        items[v] = {ZOrder(pts[v]), uint32_t(v)};
+    }
+    RadixSort(items, buffer, nullptr);
+    std::vector<Vertex> position(n);
+    for (Index v = 0; v < n; ++v) {
+        position[items[v].index] = v;
+        points_[v] = pts[items[v].index];
+        vertex_ids_[v] = items[v].index;
+    }
+    auto centroid = [&](const IdTriangle &t) {
+        return Point2D(
+            (pts[t.vertices[0]] + pts[t.vertices[1]] + pts[t.vertices[2]]) /
+            3);
+    };
+    items.resize(triangles.size());
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        for ([[maybe_unused]] Index v : triangles[t].vertices) {
+            assert(0 <= v and v < n);
+        }
+        items[t] = {ZOrder(centroid(triangles[t])), uint32_t(t)};
+    }
+    RadixSort(items, buffer, nullptr);
+    std::vector<int32_t> triangle_position(triangles.size());
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        triangle_position[items[t].index] = t;
+    }
+    triangles_.resize(triangles.size());
+    triangle_ids_.resize(triangles.size());
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        const IdTriangle &from = triangles[items[t].index];
+        triangle_ids_[t] = items[t].index;
+        for (int k = 0; k < 3; ++k) {
+            triangles_[t].v[k] = position[from.vertices[k]];
+            triangles_[t].nb[k] = from.neighbors[k] == kNoNeighbor
+                                      ? kNoNeighbor
+                                      : triangle_position[from.neighbors[k]];
+        }
+    }
+
+    // every edge once, from the triangle with the higher id or the only one
+    auto for_each_edge = [this](auto &&f) {
+        for (size_t t = 0; t < triangles_.size(); ++t) {
+            const Triangle &tri = triangles_[t];
+            for (int k = 0; k < 3; ++k) {
+                if (tri.nb[k] < int32_t(t)) {
+                    f(tri.v[(k + 1) % 3], tri.v[(k + 2) % 3]);
+                }
+            }
+        }
+    };
+    for_each_edge([this](Vertex a, Vertex b) {
+        ++offsets_[a + 1];
+        ++offsets_[b + 1];
+    });
+    for (Index v = 0; v < n; ++v) {
+        offsets_[v + 1] += offsets_[v];
+    }
+    adjacent_.resize(offsets_[n]);
+    std::vector<uint32_t> next(begin(offsets_), end(offsets_) - 1);
+    for_each_edge([&](Vertex a, Vertex b) {
+        adjacent_[next[a]++] = b;
+        adjacent_[next[b]++] = a;
+    });
+
+    // a triangle per cell its centroid falls in, then the empty cells take
+    // the triangle of the closest cell that has one, breadth first
+    std::vector<uint32_t> queue;
+    for (size_t t = 0; t < triangles_.size(); ++t) {
+        uint32_t c = StartCell(centroid(triangles[triangle_ids_[t]]));
+        if (cells_[c] == kEmptyCell) {
+            queue.push_back(c);
+        }
+        cells_[c] = t;
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        uint32_t c = queue[i];
+        int x = c % columns_, y = c / columns_;
+        auto visit = [&](int nx, int ny) {
+            if (0 <= nx and nx < columns_ and 0 <= ny and ny < rows_) {
+                uint32_t d = uint32_t(ny) * columns_ + nx;
+                if (cells_[d] == kEmptyCell) {
+                    cells_[d] = cells_[c];
+                    queue.push_back(d);
+                }
+            }
+        };
+        visit(x - 1, y);
+        visit(x + 1, y);
+        visit(x, y - 1);
+        visit(x, y + 1);
+    }
+
+    // the vertex nearest to the center of every cell, from a corner of its
+    // triangle on
+    cell_vertices_.resize(cells_.size());
+    for (size_t c = 0; c < cells_.size(); ++c) {
+        Point2D center = origin_ + Point2D(c % columns_ + .5,
+                                           c / columns_ + .5) /
+                                       inverse_cell_;
+        cell_vertices_[c] = Climb(center, triangles_[cells_[c]].v[0]);
+    }
+}
+
+uint64_t PointLocator::ZOrder(const Point2D &p) const {
+    int x = ClampCell((p(0) - origin_(0)) * inverse_cell_, columns_);
+    int y = ClampCell((p(1) - origin_(1)) * inverse_cell_, rows_);
+    return Spread(x) | Spread(y) << 1;
+}
+
+uint32_t PointLocator::StartCell(const Point2D &q) const {
+    int x = ClampCell((q(0) - origin_(0)) * inverse_cell_, columns_);
+    int y = ClampCell((q(1) - origin_(1)) * inverse_cell_, rows_);
+    return uint32_t(y) * columns_ + x;
+}
+
+bool PointLocator::Walk(const Point2D &q, uint32_t &t) const {
+    t = cells_[StartCell(q)];
+    // the edge of `t` the walk came in through, `q` lies inside of it
+    int from = -1;
+    for (;;) {
+        const Triangle &tri = triangles_[t];
+        int k = 0;
+        for (; k < 3; ++k) {
+            if (k != from and OrientationDeterminant(
+                                  points_[tri.v[(k + 1) % 3]],
+                                  points_[tri.v[(k + 2) % 3]], q) < 0) {
+                break;
+            }
+        }
+        if (k == 3) {
+            return true;
+        }
+        int32_t next = tri.nb[k];
+        if (next == kNoNeighbor) {
+            return false;
+        }
+        const Triangle &n = triangles_[next];
+        from = n.nb[0] == int32_t(t) ? 0 : n.nb[1] == int32_t(t) ? 1 : 2;
+        t = next;
+    }
+}
+
+Index PointLocator::Locate(const Point2D &q) const {
+    uint32_t t;
+    if (triangles_.empty() or not Walk(q, t)) {
+        return kNoNeighbor;
+    }
+    return triangle_ids_[t];
+}
+
+Index PointLocator::NearestVertex(const Point2D &q) const {
+    if (triangles_.empty()) {
+        // all on a line, or fewer than three
+        Index best = kNoNeighbor;
+        for (size_t v = 0; v < points_.size(); ++v) {
+            if (best == kNoNeighbor or SquaredDistance(points_[v], q) <
+                                           SquaredDistance(points_[best], q)) {
+                best = v;
+            }
+        }
+        return best;
+    }
+    return vertex_ids_[Climb(q, cell_vertices_[StartCell(q)])];
+}
+
+PointLocator::Vertex PointLocator::Climb(const Point2D &q, Vertex v) const {
+    double distance = SquaredDistance(points_[v], q);
+    // a vertex closer than all its Delaunay neighbors is a nearest one
+    for (Vertex from = ~Vertex(0); from != v;) {
+        from = v;
+        for (uint32_t i = offsets_[from]; i < offsets_[from + 1]; ++i) {
+            double d = SquaredDistance(points_[adjacent_[i]], q);
+            if (d < distance) {
+                v = adjacent_[i];
+                distance = d;
+            }
+        }
+    }
+    return v;
+}
+
+template <typename F>
+void PointLocator::ForEachQuery(size_t count, int threads, const F &f) const {
+    size_t tasks = (count + kQueriesPerTask - 1) / kQueriesPerTask;
+    auto workers = MakeWorkers(tasks > 1 ? threads : 1);
+    ForEachBlock(
+        workers.get(), count, kQueriesPerTask, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                f(i);
+            }
+        });
+}
+
+void PointLocator::Locate(
+    const Point2D *queries, size_t count, Index *result, int threads) const {
+    ForEachQuery(
+        count, threads, [&](size_t i) { result[i] = Locate(queries[i]); });
+}
+
+void PointLocator::NearestVertices(
+    const Point2D *queries, size_t count, Index *result, int threads) const {
+    ForEachQuery(count, threads, [&](size_t i) {
+        result[i] = NearestVertex(queries[i]);
+    });
+}
+
+} // namespace triangulation
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace triangulation {
+
+// Point location and nearest-vertex queries over a finished Delaunay
+// triangulation, as TriangulateFaces returns it.
+//
+// A uniform grid over the points holds a triangle near every cell, where a
+// query starts a visibility walk: from triangle to neighbor across the
+// first edge the query lies strictly beyond, which the Delaunay property
+// keeps from ever cycling. The grid has about one cell per two triangles,
+// so a walk takes a few steps, and vertices and triangles are kept in
+// Z-order over the grid, so its steps mostly stay in cache. Nearest-vertex
+// queries need no walk: they start at the vertex nearest to the center of
+// the cell and move to the closest Delaunay neighbor for as long as it is
+// closer, which ends at a nearest vertex on the Delaunay graph.
+struct PointLocator {
+  public:
+    // triangle ids are positions in `triangles`, whose vertices are
+    // positions in `pts[0, n)`; both can be released afterwards
+    PointLocator(
+        const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles);
+
+    // the triangle holding `q`, one of those whose boundary it lies on if
+    // more than one; kNoNeighbor outside the convex hull
+    Index Locate(const Point2D &q) const;
+
+    // a vertex nearest to `q`, kNoNeighbor without any points
+    Index NearestVertex(const Point2D &q) const;
+
+    // Locate and NearestVertex for `count` queries into `result`, blocks of
+    // queries spread over `threads` workers
+    void Locate(
+        const Point2D *queries, size_t count, Index *result,
+        int threads = 1) const;
+    void NearestVertices(
+        const Point2D *queries, size_t count, Index *result,
+        int threads = 1) const;
+
+  private:
+    using Vertex = uint32_t;
+
+    // kNoNeighbor across hull edges, nb[k] lies opposite v[k] as in
+    // IdTriangle
+    struct Triangle {
+        Vertex v[3];
+        int32_t nb[3];
+    };
+
+    // the walk from the grid cell of `q` to the triangle `t` holding it;
+    // false when `q` turns out to lie beyond a hull edge of `t`
+    bool Walk(const Point2D &q, uint32_t &t) const;
+
+    // the grid cell of `q`, the closest one for points outside the grid
+    uint32_t StartCell(const Point2D &q) const;
+
+    // a vertex nearest to `q`, from `v` to ever closer Delaunay neighbors
+    Vertex Climb(const Point2D &q, Vertex v) const;
+
+    // the Z-order curve position of the grid cell of `p`
+    uint64_t ZOrder(const Point2D &p) const;
+
+    template <typename F>
+    void ForEachQuery(size_t count, int threads, const F &f) const;
+
+    // vertices and triangles renumbered, vertex v being the point with id
+    // vertex_ids_[v] and triangle t the one with id triangle_ids_[t]
+    std::vector<Point2D> points_;
+    std::vector<Index> vertex_ids_;
+    std::vector<Triangle> triangles_;
+    std::vector<uint32_t> triangle_ids_;
+
+    // the Delaunay neighbors of vertex v are adjacent_[offsets_[v],
+    // offsets_[v + 1])
+    std::vector<uint32_t> offsets_;
+    std::vector<Vertex> adjacent_;
+
+    Point2D origin_ = Point2D::Zero();
+    double inverse_cell_ = 0;
+    int columns_ = 0, rows_ = 0;
+    std::vector<uint32_t> cells_;
+    // where the nearest-vertex climbs from every cell start
+    std::vector<Vertex> cell_vertices_;
+};
+
+} // namespace triangulation
@@ -0,0 +1,128 @@
+#include "triangulation/stats.h"
+
+#include "triangulation/predicates.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace triangulation {
+
+namespace stats {
+
+bool enabled = false;
+
+namespace {
+
+void Add(Block &total, const Block &block) {
+    for (int i = 0; i < kCounterCount; ++i) {
+        total.counters[i] += block.counters[i];
+    }
+    for (int i = 0; i < kPhaseCount; ++i) {
+        total.phase_ns[i] += block.phase_ns[i];
+        total.phase_calls[i] += block.phase_calls[i];
+    }
+    for (int i = 0; i < kMaxDepth; ++i) {
+        total.merges[i] += block.merges[i];
+        total.merge_edges[i] += block.merge_edges[i];
+    }
+}
+
+// the blocks of the live threads, and the sum of the ones that exited:
+// the pool workers are gone by the time the stats of a run are read
+std::mutex registry_mutex;
+std::vector<Block *> registry;
+Block retired;
+
+// the block of a thread, registered on first use and added to `retired`
+// when the thread exits
+struct LocalBlock {
+  public:
+    Block block;
+    bool registered = false;
+
+    ~LocalBlock() {
+        if (not registered) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        Add(retired, block);
+        registry.erase(std::find(begin(registry), end(registry), &block));
+    }
+};
+
+thread_local LocalBlock local_block;
+
+const char *const kCounterNames[kCounterCount] = {
+    "orientation_calls", "in_circle_calls", "edges_added", "edges_removed"};
+
+const char *const kPhaseNames[kPhaseCount] = {
+    "sort", "recurse", "hull_merge", "merge_base_edge", "collect_edges"};
+
+} // namespace
+
+void SetEnabled(bool on) {
+    enabled = on;
+}
+
+Block &Local() {
+    if (not local_block.registered) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(&local_block.block);
+        local_block.registered = true;
+    }
+    return local_block.block;
+}
+
+void Reset() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (Block *block : registry) {
+        *block = Block{};
+    }
+    retired = Block{};
+    predicates::ResetExactFallbacks();
+}
+
+Block Total() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Block total = retired;
+    for (const Block *block : registry) {
+        Add(total, *block);
+    }
+    return total;
+}
+
+void WriteJson(const Block &total, FILE *f) {
+    fprintf(f, "{\n  \"phases\": {\n");
+    for (int i = 0; i < kPhaseCount; ++i) {
+        fprintf(
+            f, "    \"%s\": {\"ms\": %.3f, \"calls\": %lld}%s\n",
+            kPhaseNames[i], total.phase_ns[i] / 1e6, total.phase_calls[i],
+            i + 1 < kPhaseCount ? "," : "");
+    }
+    fprintf(f, "  },\n  \"counters\": {\n");
+    for (int i = 0; i < kCounterCount; ++i) {
+        fprintf(f, "    \"%s\": %lld,\n", kCounterNames[i], total.counters[i]);
+    }
+    auto fallbacks = predicates::ExactFallbacks();
+    fprintf(
+        f,
+        "    \"exact_orientation_fallbacks\": %lld,\n"
+        "    \"exact_in_circle_fallbacks\": %lld\n",
+        fallbacks.orientation, fallbacks.in_circle);
+    fprintf(f, "  },\n  \"merge_depths\": [");
+    int deepest = kMaxDepth;
+    while (deepest > 0 and total.merges[deepest - 1] == 0) {
+        --deepest;
+    }
+    for (int i = 0; i < deepest; ++i) {
+        fprintf(
+            f, "%s\n    {\"depth\": %d, \"merges\": %lld, \"edges\": %lld}",
+            i == 0 ? "" : ",", i, total.merges[i], total.merge_edges[i]);
+    }
+    fprintf(f, "%s]\n}\n", deepest > 0 ? "\n  " : "");
+}
+
+} // namespace stats
+
+} // namespace triangulation
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+
+// Hot path instrumentation: phase timers, event counters and a histogram
+// of merges by recursion depth.
+//
+// Compiled in when TRIANGULATION_STATS is nonzero (the CMake option of the
+// same name) and recorded only after stats::SetEnabled(true), so a build
+// with stats pays one predictable branch per event while they are off.
+// Every thread records into a block of its own, blocks are summed when
+// the stats are read, which must not overlap a triangulation run.
+
+#ifndef TRIANGULATION_STATS
+#define TRIANGULATION_STATS 0
+#endif
+
+namespace triangulation {
+
+namespace stats {
+
+enum Counter {
+    kOrientationCalls,
+    kInCircleCalls,
+    kEdgesAdded,
+    kEdgesRemoved,
+    kCounterCount,
+};
+
+// phases nest: kRecurse holds kHullMerge and kMergeBaseEdge, whose times
+// are summed over threads; kCollectEdges also covers collecting triangles
+enum Phase {
+    kSort,
+    kRecurse,
+    kHullMerge,
+    kMergeBaseEdge,
+    kCollectEdges,
+    kPhaseCount,
+};
+
+constexpr int kMaxDepth = 64;
+
+struct Block {
+    long long counters[kCounterCount] = {};
+    long long phase_ns[kPhaseCount] = {};
+    long long phase_calls[kPhaseCount] = {};
+    // merges at each recursion depth and the edges they added
+    long long merges[kMaxDepth] = {};
+    long long merge_edges[kMaxDepth] = {};
+};
+
+extern bool enabled;
+
+inline bool Enabled() {
+    return enabled;
+}
+
+// must not be called while a triangulation runs
+void SetEnabled(bool on);
+
+// the calling thread's block
+Block &Local();
+
+// zeroes the blocks of every thread
+void Reset();
+
+// the sum over the blocks of every thread
+Block Total();
+
+void WriteJson(const Block &total, FILE *f);
+
+inline long long Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct ScopedPhase {
+    ScopedPhase(Phase phase) : phase_(phase), start_(Enabled() ? Now() : 0) {}
+
+    ~ScopedPhase() {
+        if (start_ != 0) {
+            Block &block = Local();
+            block.phase_ns[phase_] += Now() - start_;
+            ++block.phase_calls[phase_];
+        }
+    }
+
+  private:
+    Phase phase_;
+    long long start_;
+};
+
+// records one merge at `depth`, counting the edges added in its scope
+struct ScopedMerge {
+    ScopedMerge(int depth)
+        : depth_(depth < kMaxDepth ? depth : kMaxDepth - 1),
+          edges_before_(Enabled() ? Local().counters[kEdgesAdded] : -1) {}
+
+    ~ScopedMerge() {
+        if (edges_before_ >= 0) {
+            Block &block = Local();
+            ++block.merges[depth_];
+            block.merge_edges[depth_] +=
+                block.counters[kEdgesAdded] - edges_before_;
+        }
+    }
+
+  private:
+    int depth_;
+    long long edges_before_;
+};
+
+} // namespace stats
+
+} // namespace triangulation
+
+#define STATS_CONCAT_IMPL(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_IMPL(a, b)
+
+#if TRIANGULATION_STATS
+
+#define STATS_ADD(counter, n)                                                  \
+    do {                                                                       \
+        if (::triangulation::stats::Enabled()) {                               \
+            ::triangulation::stats::Local()                                    \
+                .counters[::triangulation::stats::counter] += (n);             \
+        }                                                                      \
+    } while (0)
+#define STATS_COUNT(counter) STATS_ADD(counter, 1)
+#define STATS_PHASE(phase)                                                     \
+    ::triangulation::stats::ScopedPhase STATS_CONCAT(stats_phase_, __LINE__)(  \
+        ::triangulation::stats::phase)
+#define STATS_MERGE(depth)                                                     \
+    ::triangulation::stats::ScopedMerge STATS_CONCAT(stats_merge_, __LINE__)(  \
+        depth)
+
+#else
+
+#define STATS_ADD(counter, n)
+#define STATS_COUNT(counter)
+#define STATS_PHASE(phase)
+#define STATS_MERGE(depth)
+
+#endif
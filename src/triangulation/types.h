@@ -10,7 +10,7 @@ namespace triangulation {
 
 using Point2D = Eigen::Matrix<double, 2, 1>;
 
-using Index = std::int64_t;
+using Index = long long;
 
 struct PointRef {
     Point2D point;
@@ -37,6 +37,15 @@ struct IdEdge {
     Index p1, p2;
 };
 
+constexpr Index kNoNeighbor = -1;
+
+// a counter-clockwise triangle and the triangles next to it: neighbors[k]
+// lies across the edge opposite vertices[k], kNoNeighbor on the hull
+struct IdTriangle {
+    Index vertices[3];
+    Index neighbors[3];
+};
+
 inline bool operator==(const EdgeRef &e1, const EdgeRef &e2) {
     return std::tie(e1.p1, e1.p2) == std::tie(e2.p1, e2.p2) or
            std::tie(e1.p1, e1.p2) == std::tie(e2.p2, e2.p1);
@@ -46,14 +55,18 @@ inline bool operator!=(const EdgeRef& e1, const EdgeRef& e2) {
     return not (e1 == e2);
 }
 
-inline std::vector<PointRef>
-TagPointWithIndex(const std::vector<Point2D> &pts) {
+inline std::vector<PointRef> TagPointWithIndex(const Point2D *pts, Index n) {
     std::vector<PointRef> result;
-    result.reserve(pts.size());
-    for (int i = 0; i < pts.size(); ++i) {
+    result.reserve(n);
+    for (Index i = 0; i < n; ++i) {
         result.push_back(PointRef{pts[i], i});
     }
     return result;
 }
 
+inline std::vector<PointRef>
+TagPointWithIndex(const std::vector<Point2D> &pts) {
+    return TagPointWithIndex(pts.data(), pts.size());
+}
+
 } // namespace triangulation
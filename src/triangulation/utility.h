@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Eigen/Dense"
+#include "triangulation/predicates.h"
 #include "triangulation/types.h"
 
 #include <stdio.h>
@@ -12,9 +13,7 @@ enum Orientation { kUnknown = 0, kClockwise = 1, kCounterClockwise = 2 };
 
 inline Orientation
 ComputeOrientation(const Point2D &p1, const Point2D &p2, const Point2D &p3) {
-    auto v1 = p1 - p2, v2 = p1 - p3;
-    double x1 = v1(0), y1 = v1(1), x2 = v2(0), y2 = v2(1);
-    double d = x1 * y2 - y1 * x2;
+    double d = OrientationDeterminant(p1, p2, p3);
     if (d < 0) return Orientation::kClockwise;
     if (d > 0) return Orientation::kCounterClockwise;
     return Orientation::kUnknown;
@@ -28,16 +27,11 @@ inline double Square(double x) {
     return x * x;
 }
 
+// whether d lies strictly inside the circle through the counter-clockwise
+// a, b, c
 inline bool InCircle(
     const Point2D &a, const Point2D &b, const Point2D &c, const Point2D &d) {
-    double ax = a(0), ay = a(1), bx = b(0), by = b(1), cx = c(0), cy = c(1),
-           dx = d(0), dy = d(1);
-    double adx = ax - dx, ady = ay - dy, bdx = bx - dx, bdy = by - dy,
-           cdx = cx - dx, cdy = cy - dy;
-    Eigen::Matrix3d m;
-    m << adx, ady, (Square(adx) + Square(ady)), bdx, bdy,
-        (Square(bdx) + Square(bdy)), cdx, cdy, (Square(cdx) + Square(cdy));
-    return m.determinant() > 0;
+    return InCircleDeterminant(a, b, c, d) > 0;
 }
 
 inline bool InCircleO(
@@ -0,0 +1,400 @@
+#include "triangulation/verify.h"
+
+#include "triangulation/parallel/radix-sort.h"
+#include "triangulation/parallel/work-stealing-pool.h"
+#include "triangulation/predicates.h"
+#include "triangulation/utility.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdint.h>
+#include <stdio.h>
+#include <tuple>
+#include <utility>
+
+namespace triangulation {
+
+namespace {
+
+// triangles one task checks, and whose fans it walks
+constexpr size_t kTrianglesPerTask = 1 << 14;
+
+// messages a report keeps, the counts go on
+constexpr size_t kMaxMessages = 20;
+
+// what the checks of one block found, added to the report in block order
+// so that the messages do not depend on the scheduling
+struct Findings {
+    Index bad_triangles = 0;
+    Index bad_neighbors = 0;
+    Index bad_fans = 0;
+    Index non_delaunay_edges = 0;
+    std::vector<std::string> messages;
+
+    // counts one violation and describes it, printf style
+    template <typename... Args>
+    void Note(Index &count, const char *format, Args... args) {
+        ++count;
+        if (messages.size() < kMaxMessages) {
+            char message[160];
+            snprintf(message, sizeof(message), format, args...);
+            messages.push_back(message);
+        }
+    }
+
+    void AddTo(VerificationReport &report) const {
+        report.bad_triangles += bad_triangles;
+        report.bad_neighbors += bad_neighbors;
+        report.bad_fans += bad_fans;
+        report.non_delaunay_edges += non_delaunay_edges;
+        for (const auto &m : messages) {
+            if (report.messages.size() < kMaxMessages) {
+                report.messages.push_back(m);
+            }
+        }
+    }
+};
+
+// The checks of one triangle or one vertex, each on its own
+struct Checker {
+  public:
+    Checker(
+        const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles)
+        : pts_(pts), n_(n), triangles_(triangles) {}
+
+    // The vertices of triangle `t`, its turn and the links to its
+    // neighbors, which must cross the same edge back. The circle test of
+    // the edge a link crosses is made from the triangle with the lower id.
+    void CheckTriangle(Index t, Findings &f) const {
+        const Index *v = triangles_[t].vertices;
+        Index size = triangles_.size();
+        if (std::any_of(v, v + 3, [&](Index u) { return u < 0 or u >= n_; }) or
+            v[0] == v[1] or v[1] == v[2] or v[2] == v[0]) {
+            f.Note(
+                f.bad_triangles,
+                "triangle %lld has the vertices %lld %lld %lld", t, v[0], v[1],
+                v[2]);
+            return;
+        }
+        const Point2D &a = pts_[v[0]], &b = pts_[v[1]], &c = pts_[v[2]];
+        bool ccw = OrientationDeterminant(a, b, c) > 0;
+        if (not ccw) {
+            f.Note(
+                f.bad_triangles, "triangle %lld is not counter-clockwise", t);
+        }
+        for (int k = 0; k < 3; ++k) {
+            Index u = triangles_[t].neighbors[k];
+            if (u == kNoNeighbor) {
+                continue;
+            }
+            if (u < 0 or u >= size or u == t) {
+                f.Note(
+                    f.bad_neighbors, "triangle %lld has the neighbor %lld", t,
+                    u);
+                continue;
+            }
+            const IdTriangle &other = triangles_[u];
+            int j = 0;
+            while (j < 3 and other.neighbors[j] != t) {
+                ++j;
+            }
+            Index from = v[(k + 1) % 3], to = v[(k + 2) % 3];
+            if (j == 3 or other.vertices[(j + 1) % 3] != to or
+                other.vertices[(j + 2) % 3] != from) {
+                f.Note(
+                    f.bad_neighbors,
+                    "triangles %lld and %lld disagree about the edge %lld %lld",
+                    t, u, from, to);
+                continue;
+            }
+            Index w = other.vertices[j];
+            if (t < u and ccw and 0 <= w and w < n_ and
+                InCircle(a, b, c, pts_[w])) {
+                f.Note(
+                    f.non_delaunay_edges,
+                    "point %lld of triangle %lld lies inside the circumcircle "
+                    "of triangle %lld",
+                    w, u, t);
+            }
+        }
+    }
+
+    // The fan around `v` counter-clockwise from `first`, and clockwise too
+    // when that reaches the hull, must meet all `degree` triangles of v.
+    void CheckFan(Index v, Index first, uint32_t degree, Findings &f) const {
+        Index t = first, fan = 0;
+        do {
+            ++fan;
+            t = Step(t, v, 1);
+        } while (t != kNoNeighbor and t != first and fan <= degree);
+        if (t == kNoNeighbor) {
+            for (t = Step(first, v, 2); t != kNoNeighbor and fan <= degree;
+                 t = Step(t, v, 2)) {
+                ++fan;
+            }
+        }
+        if (fan != degree) {
+            f.Note(
+                f.bad_fans, "point %lld is in %u triangles, its fan has %lld",
+                v, degree, fan);
+        }
+    }
+
+  private:
+    // the triangle after `t` around `v`, counter-clockwise for `turn` 1
+    // and clockwise for 2
+    Index Step(Index t, Index v, int turn) const {
+        const IdTriangle &tri = triangles_[t];
+        int k = tri.vertices[0] == v ? 0 : tri.vertices[1] == v ? 1 : 2;
+        return tri.neighbors[(k + turn) % 3];
+    }
+
+    const Point2D *pts_;
+    Index n_;
+    const std::vector<IdTriangle> &triangles_;
+};
+
+// b lies strictly between a and c on the line through them
+bool Between(const Point2D &a, const Point2D &b, const Point2D &c) {
+    auto key = [](const Point2D &p) { return std::make_tuple(p(0), p(1)); };
+    return (key(a) < key(b) and key(b) < key(c)) or
+           (key(c) < key(b) and key(b) < key(a));
+}
+
+// The points sorted from left to right, ties from bottom to top, as the
+// triangulation sorts them: radix passes on the x keys, then the runs
+// sharing an x on y.
+std::vector<uint32_t>
+SortedPoints(const Point2D *pts, Index n, WorkStealingPool *workers) {
+    std::vector<RadixItem> items(n), buffer;
+    for (Index i = 0; i < n; ++i) {
+        items[i] = {OrderedBits(pts[i](0)), uint32_t(i)};
+    }
+    RadixSort(items, buffer, workers);
+    std::vector<uint32_t> order(n);
+    for (Index i = 0; i < n; ++i) {
+        order[i] = items[i].index;
+    }
+    for (Index i = 0, j; i < n; i = j) {
+        j = i + 1;
+        while (j < n and items[j].key == items[i].key) {
+            ++j;
+        }
+        if (j - i > 1) {
+            std::sort(
+                begin(order) + i, begin(order) + j,
+                [&](uint32_t l, uint32_t r) { return pts[l](1) < pts[r](1); });
+        }
+    }
+    return order;
+}
+
+// the corners of the convex hull of the sorted, distinct `order`
+// counter-clockwise from the first point, without points on its edges
+std::vector<uint32_t>
+ConvexHullOf(const Point2D *pts, const std::vector<uint32_t> &order) {
+    std::vector<uint32_t> hull;
+    if (order.size() < 2) {
+        return order;
+    }
+    auto turns_left = [&](uint32_t a, uint32_t b, uint32_t c) {
+        return OrientationDeterminant(pts[a], pts[b], pts[c]) > 0;
+    };
+    // the lower hull from left to right, then the upper one back
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t lower = hull.size();
+        for (size_t k = 0; k < order.size(); ++k) {
+            uint32_t p = order[pass == 0 ? k : order.size() - 1 - k];
+            while (hull.size() >= lower + 2 and
+                   not turns_left(hull[hull.size() - 2], hull.back(), p)) {
+                hull.pop_back();
+            }
+            hull.push_back(p);
+        }
+        hull.pop_back();
+    }
+    return hull;
+}
+
+} // namespace
+
+VerificationReport VerifyDelaunay(
+    const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles,
+    int threads) {
+    auto workers = MakeWorkers(threads);
+    VerificationReport report;
+    Index size = triangles.size();
+
+    Checker checker(pts, n, triangles);
+
+    // every triangle on its own, and every link from both of its ends
+    std::vector<Findings> found(
+        (size + kTrianglesPerTask - 1) / kTrianglesPerTask);
+    ForEachBlock(
+        workers.get(), size, kTrianglesPerTask,
+        [&](size_t begin, size_t end) {
+            Findings &f = found[begin / kTrianglesPerTask];
+            for (Index t = begin; t < Index(end); ++t) {
+                checker.CheckTriangle(t, f);
+            }
+        });
+    for (const auto &f : found) {
+        f.AddTo(report);
+    }
+
+    // what follows walks the links, which are only sound by now if every
+    // triangle and link passed
+    std::vector<uint32_t> degree(n, 0);
+    std::vector<Index> incident(n, kNoNeighbor);
+    // the edges on the outer face, counter-clockwise around the hull
+    std::vector<std::pair<Index, Index>> boundary;
+    bool linked = report.bad_triangles == 0 and report.bad_neighbors == 0;
+    if (linked) {
+        for (Index t = 0; t < size; ++t) {
+            const IdTriangle &tri = triangles[t];
+            for (int k = 0; k < 3; ++k) {
+                ++degree[tri.vertices[k]];
+                incident[tri.vertices[k]] = t;
+                if (tri.neighbors[k] == kNoNeighbor) {
+                    boundary.emplace_back(
+                        tri.vertices[(k + 1) % 3], tri.vertices[(k + 2) % 3]);
+                }
+            }
+        }
+        // every fan is walked from the triangle it is incident to, in the
+        // order of the triangles rather than of the points, so the walks
+        // of one block stay among nearby triangles
+        found.assign(found.size(), {});
+        ForEachBlock(
+            workers.get(), size, kTrianglesPerTask,
+            [&](size_t begin, size_t end) {
+                Findings &f = found[begin / kTrianglesPerTask];
+                for (Index t = begin; t < Index(end); ++t) {
+                    for (Index v : triangles[t].vertices) {
+                        if (incident[v] == t) {
+                            checker.CheckFan(v, t, degree[v], f);
+                        }
+                    }
+                }
+            });
+        for (const auto &f : found) {
+            f.AddTo(report);
+        }
+    }
+    auto note = [&](const char *format, auto... args) {
+        if (report.messages.size() < kMaxMessages) {
+            char message[160];
+            snprintf(message, sizeof(message), format, args...);
+            report.messages.push_back(message);
+        }
+    };
+
+    // a disk has V - E + F = 1, where every triangle has three edges and
+    // every edge but those on the boundary two triangles
+    Index vertices = std::count_if(
+        begin(degree), end(degree), [](uint32_t d) { return d > 0; });
+    Index edges = (3 * size + boundary.size()) / 2;
+    if (linked and size > 0 and vertices - edges + size != 1) {
+        report.euler_mismatch = true;
+        note(
+            "%lld vertices - %lld edges + %lld triangles is not 1", vertices,
+            edges, size);
+    }
+
+    // every point is a vertex or coincides with one
+    auto order = SortedPoints(pts, n, workers.get());
+    std::vector<uint32_t> distinct;
+    for (Index i = 0, j; i < n; i = j) {
+        bool used = false;
+        for (j = i; j < n and pts[order[j]] == pts[order[i]]; ++j) {
+            used |= degree[order[j]] > 0;
+        }
+        distinct.push_back(order[i]);
+        if (linked and size > 0 and not used) {
+            report.missing_points += j - i;
+            note("point %u is in no triangle", order[i]);
+        }
+    }
+    auto hull = ConvexHullOf(pts, distinct);
+    if (size == 0) {
+        if (hull.size() > 2) {
+            report.hull_mismatch = true;
+            note("%s", "no triangles, but the points are not all on a line");
+        }
+        return report;
+    }
+    if (not linked) {
+        return report;
+    }
+
+    // the boundary is one loop turning left or going straight on, and
+    // its corners are the hull
+    if (boundary.empty()) {
+        report.hull_mismatch = true;
+        note("%s", "the triangles have no boundary");
+        return report;
+    }
+    std::sort(begin(boundary), end(boundary));
+    auto next = [&](Index a) {
+        auto it = std::lower_bound(
+            begin(boundary), end(boundary), std::make_pair(a, Index(0)));
+        return it != end(boundary) and it->first == a ? it->second
+                                                      : kNoNeighbor;
+    };
+    for (size_t i = 1; i < boundary.size(); ++i) {
+        if (boundary[i].first == boundary[i - 1].first) {
+            report.hull_mismatch = true;
+            note(
+                "two boundary edges leave point %lld",
+                (long long)boundary[i].first);
+            return report;
+        }
+    }
+    std::vector<Index> loop{boundary[0].first};
+    for (Index p = boundary[0].second;
+         p != boundary[0].first and p != kNoNeighbor and
+         loop.size() <= boundary.size();
+         p = next(p)) {
+        loop.push_back(p);
+    }
+    if (loop.size() != boundary.size()) {
+        report.hull_mismatch = true;
+        note(
+            "the boundary walk from point %lld meets %zu of %zu edges",
+            loop[0], loop.size(), boundary.size());
+        return report;
+    }
+    std::vector<Index> corners;
+    for (size_t i = 0; i < loop.size(); ++i) {
+        const Point2D &a = pts[loop[(i + loop.size() - 1) % loop.size()]];
+        const Point2D &b = pts[loop[i]], &c = pts[loop[(i + 1) % loop.size()]];
+        double turn = OrientationDeterminant(a, b, c);
+        if (turn > 0) {
+            corners.push_back(loop[i]);
+        } else if (turn < 0 or not Between(a, b, c)) {
+            report.hull_mismatch = true;
+            note("the boundary turns back at point %lld", loop[i]);
+        }
+    }
+    // both run counter-clockwise, from wherever the corners start
+    auto start = std::find_if(begin(corners), end(corners), [&](Index c) {
+        return pts[c] == pts[hull[0]];
+    });
+    bool same = corners.size() == hull.size() and start != end(corners);
+    if (same) {
+        std::rotate(begin(corners), start, end(corners));
+        for (size_t i = 0; i < hull.size(); ++i) {
+            same &= pts[corners[i]] == pts[hull[i]];
+        }
+    }
+    if (not same) {
+        report.hull_mismatch = true;
+        note(
+            "the boundary has %zu corners that are not the %zu of the "
+            "convex hull",
+            corners.size(), hull.size());
+    }
+    return report;
+}
+
+} // namespace triangulation
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <string>
+#include <vector>
+
+namespace triangulation {
+
+// What VerifyDelaunay found wrong with a triangulation: every count zero,
+// both flags false and no messages for a valid one.
+struct VerificationReport {
+    // triangles with a vertex out of range or repeated, or whose vertices
+    // are not strictly counter-clockwise
+    Index bad_triangles = 0;
+    // neighbor links out of range, or not returned across the same edge
+    Index bad_neighbors = 0;
+    // vertices whose triangles do not form a single fan around them
+    Index bad_fans = 0;
+    // points in no triangle that do not coincide with a point that is
+    Index missing_points = 0;
+    // edges whose far vertex on one side lies strictly inside the
+    // circumcircle of the triangle on the other
+    Index non_delaunay_edges = 0;
+    // the boundary of the triangles is not the convex hull of the points
+    bool hull_mismatch = false;
+    // vertices - edges + triangles is not 1, the triangles are no disk
+    bool euler_mismatch = false;
+
+    // the first violations found, in words
+    std::vector<std::string> messages;
+
+    bool Valid() const {
+        return bad_triangles == 0 and bad_neighbors == 0 and bad_fans == 0 and
+               missing_points == 0 and non_delaunay_edges == 0 and
+               not hull_mismatch and not euler_mismatch;
+    }
+};
+
+// Checks that `triangles`, as TriangulateFaces returns them, are a
+// Delaunay triangulation of `pts[0, n)`, with exact predicates:
+// - every triangle is counter-clockwise and its neighbor links are mutual;
+// - the triangles around every vertex form one fan, and vertices minus
+//   edges plus triangles is 1, so together they are a disk;
+// - their boundary turns the same way all around and its corners are the
+//   convex hull of the points, computed on its own, so the triangles
+//   cover the hull exactly once;
+// - every point is a vertex, or coincides with one;
+// - no triangle has the far vertex of a neighbor strictly inside its
+//   circumcircle, which for a triangulation means all circles are empty.
+// The triangles and the vertices are checked in blocks spread over
+// `threads` workers, and the hull comes from the same radix sort the
+// triangulation starts with.
+VerificationReport VerifyDelaunay(
+    const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles,
+    int threads = 1);
+
+} // namespace triangulation
@@ -0,0 +1,217 @@
+#include "triangulation/voronoi.h"
+
+#include "triangulation/parallel/radix-sort.h"
+#include "triangulation/parallel/work-stealing-pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace triangulation {
+
+namespace {
+
+// triangles whose circumcenters one task computes
+constexpr size_t kTrianglesPerTask = 1 << 14;
+
+// points whose cells one task builds
+constexpr size_t kSitesPerTask = 1 << 12;
+
+Point2D Circumcenter(const Point2D &a, const Point2D &b, const Point2D &c) {
+    double bx = b(0) - a(0), by = b(1) - a(1);
+    double cx = c(0) - a(0), cy = c(1) - a(1);
+    double d = 2 * (bx * cy - by * cx);
+    double b_lift = bx * bx + by * by, c_lift = cx * cx + cy * cy;
+    return Point2D(
+        a(0) + (cy * b_lift - by * c_lift) / d,
+        a(1) + (bx * c_lift - cx * b_lift) / d);
+}
+
+// The cell of one point at a time, in scratch space kept for the next
+struct CellBuilder {
+  public:
+    CellBuilder(
+        const Point2D *pts, const std::vector<IdTriangle> &triangles,
+        const std::vector<Point2D> &centers,
+        const std::vector<Index> &incident, const BoundingBox &box)
+        : pts_(pts), triangles_(triangles), centers_(centers),
+          incident_(incident), box_(box) {}
+
+    // appends the corners of the cell of `site` to `out`, returning how
+    // many there are
+    Index Build(Index site, std::vector<Point2D> &out) {
+        Index t = incident_[site];
+        if (t == kNoNeighbor) {
+            return 0;
+        }
+        // the circumcenters of the fan around the point counter-clockwise,
+        // which leaves the hull unless the point is an inner one
+        Index first = t;
+        bool hull = false;
+        polygon_.clear();
+        do {
+            const Point2D &center = centers_[t];
+            if (polygon_.empty() or polygon_.back() != center) {
+                polygon_.push_back(center);
+            }
+            t = triangles_[t].neighbors[(Corner(t, site) + 1) % 3];
+            hull = t == kNoNeighbor;
+        } while (not hull and t != first);
+
+        if (hull) {
+            // back clockwise to the first triangle of the fan, then all of
+            // it for the neighbors of the point
+            t = first;
+            for (;;) {
+                Index previous =
+                    triangles_[t].neighbors[(Corner(t, site) + 2) % 3];
+                if (previous == kNoNeighbor) {
+                    break;
+                }
+                t = previous;
+            }
+            neighbors_.clear();
+            for (;;) {
+                int k = Corner(t, site);
+                const Index *v = triangles_[t].vertices;
+                neighbors_.push_back(v[(k + 1) % 3]);
+                Index next = triangles_[t].neighbors[(k + 1) % 3];
+                if (next == kNoNeighbor) {
+                    neighbors_.push_back(v[(k + 2) % 3]);
+                    break;
+                }
+                t = next;
+            }
+            // the cell is unbounded, the box is cut down to it instead
+            polygon_ = {
+                box_.lo, Point2D(box_.hi(0), box_.lo(1)), box_.hi,
+                Point2D(box_.lo(0), box_.hi(1))};
+            const Point2D &p = pts_[site];
+            for (Index u : neighbors_) {
+                Point2D normal = pts_[u] - p;
+                Clip(normal, normal.dot((pts_[u] + p) / 2));
+            }
+        } else {
+            if (polygon_.size() > 1 and polygon_.back() == polygon_.front()) {
+                polygon_.pop_back();
+            }
+            bool inside = true;
+            for (const auto &c : polygon_) {
+                inside &= box_.lo(0) <= c(0) and c(0) <= box_.hi(0) and
+                          box_.lo(1) <= c(1) and c(1) <= box_.hi(1);
+            }
+            if (not inside) {
+                Clip(Point2D(-1, 0), -box_.lo(0));
+                Clip(Point2D(1, 0), box_.hi(0));
+                Clip(Point2D(0, -1), -box_.lo(1));
+                Clip(Point2D(0, 1), box_.hi(1));
+            }
+        }
+        out.insert(end(out), begin(polygon_), end(polygon_));
+        return polygon_.size();
+    }
+
+  private:
+    // where `site` is among the vertices of triangle `t`
+    int Corner(Index t, Index site) const {
+        const Index *v = triangles_[t].vertices;
+        return v[0] == site ? 0 : v[1] == site ? 1 : 2;
+    }
+
+    // keeps the part of the polygon where normal . x <= offset
+    void Clip(const Point2D &normal, double offset) {
+        clipped_.clear();
+        for (size_t i = 0; i < polygon_.size(); ++i) {
+            const Point2D &p = polygon_[i];
+            const Point2D &q = polygon_[(i + 1) % polygon_.size()];
+            double fp = normal.dot(p) - offset, fq = normal.dot(q) - offset;
+            if (fp <= 0) {
+                clipped_.push_back(p);
+            }
+            if ((fp < 0 and fq > 0) or (fp > 0 and fq < 0)) {
+                clipped_.push_back(p + (q - p) * (fp / (fp - fq)));
+            }
+        }
+        std::swap(polygon_, clipped_);
+    }
+
+    const Point2D *pts_;
+    const std::vector<IdTriangle> &triangles_;
+    const std::vector<Point2D> &centers_;
+    const std::vector<Index> &incident_;
+    BoundingBox box_;
+
+    std::vector<Point2D> polygon_, clipped_;
+    std::vector<Index> neighbors_;
+};
+
+} // namespace
+
+VoronoiDiagram ComputeVoronoi(
+    const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles,
+    const BoundingBox &box, int threads) {
+    auto workers = MakeWorkers(threads);
+
+    std::vector<Point2D> centers(triangles.size());
+    ForEachBlock(
+        workers.get(), triangles.size(), kTrianglesPerTask,
+        [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                const Index *v = triangles[t].vertices;
+                centers[t] = Circumcenter(pts[v[0]], pts[v[1]], pts[v[2]]);
+            }
+        });
+    // any triangle around every point, a fan is walked from there
+    std::vector<Index> incident(n, kNoNeighbor);
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        for (Index v : triangles[t].vertices) {
+            incident[v] = t;
+        }
+    }
+
+    // The cells are built in the order of those triangles, which lie
+    // close together in memory when they are close in the plane, so the
+    // fans of the points of one block share the triangles they walk. Every
+    // block builds its cells on its own, then each cell moves to its place.
+    std::vector<RadixItem> order(n), buffer;
+    for (Index v = 0; v < n; ++v) {
+        order[v] = {uint64_t(incident[v]), uint32_t(v)};
+    }
+    RadixSort(order, buffer, workers.get());
+    std::vector<RadixItem>().swap(buffer);
+    VoronoiDiagram result;
+    result.offsets.assign(n + 1, 0);
+    // where the cell of order[i] starts in the corners of its block
+    std::vector<Index> start(n);
+    size_t blocks = (n + kSitesPerTask - 1) / kSitesPerTask;
+    std::vector<std::vector<Point2D>> block_corners(blocks);
+    ForEachBlock(
+        workers.get(), n, kSitesPerTask, [&](size_t begin, size_t end) {
+            CellBuilder builder(pts, triangles, centers, incident, box);
+            auto &out = block_corners[begin / kSitesPerTask];
+            for (size_t i = begin; i < end; ++i) {
+                start[i] = out.size();
+                Index site = order[i].index;
+                result.offsets[site + 1] = builder.Build(site, out);
+            }
+        });
+    for (Index i = 0; i < n; ++i) {
+        result.offsets[i + 1] += result.offsets[i];
+    }
+    result.corners.resize(result.offsets[n]);
+    ForEachBlock(
+        workers.get(), n, kSitesPerTask, [&](size_t begin, size_t end) {
+            const auto &corners = block_corners[begin / kSitesPerTask];
+            for (size_t i = begin; i < end; ++i) {
+                Index site = order[i].index;
+                std::copy(
+                    corners.begin() + start[i],
+                    corners.begin() + start[i] + result.offsets[site + 1] -
+                        result.offsets[site],
+                    result.corners.begin() + result.offsets[site]);
+            }
+        });
+    return result;
+}
+
+} // namespace triangulation
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "triangulation/types.h"
+
+#include <vector>
+
+namespace triangulation {
+
+struct BoundingBox {
+    Point2D lo, hi;
+};
+
+// The Voronoi cells of the points, each clipped to a box, in compressed
+// rows: the cell of point i is the convex polygon with the
+// counter-clockwise corners corners[offsets[i], offsets[i + 1]). A cell
+// missing the box, or of a point in no triangle, has no corners.
+struct VoronoiDiagram {
+    std::vector<Index> offsets;
+    std::vector<Point2D> corners;
+
+    Index Size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+};
+
+// The Voronoi diagram dual to the Delaunay `triangles` of `pts[0, n)`, as
+// TriangulateFaces returns them. The circumcenters of the triangles around
+// a point are the corners of its cell; cells crossing the box are clipped
+// to it, and the unbounded cells of hull points are cut out of the box by
+// the bisectors to their neighbors. The circumcenters and the cells are
+// computed in blocks spread over `threads` workers.
+VoronoiDiagram ComputeVoronoi(
+    const Point2D *pts, Index n, const std::vector<IdTriangle> &triangles,
+    const BoundingBox &box, int threads = 1);
+
+} // namespace triangulation